@@ -0,0 +1,548 @@
+// Created by: Tanvir Tatla
+
+#include "bitkernels.h"
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITKERNELS_X86 1
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// --------------------------------------------------------------------------
+// Word operations. Each one knows how to combine a pair of words and, on
+// x86, a pair of 128, 256 or 512-bit vectors.
+
+struct OrOp {
+   static uint64_t word(uint64_t a, uint64_t b) { return a | b; }
+#ifdef BITKERNELS_X86
+   TARGET("sse2") static __m128i sse2(__m128i a, __m128i b)
+   {
+      return _mm_or_si128(a, b);
+   }
+   TARGET("avx2") static __m256i avx2(__m256i a, __m256i b)
+   {
+      return _mm256_or_si256(a, b);
+   }
+   TARGET("avx512f") static __m512i avx512(__m512i a, __m512i b)
+   {
+      return _mm512_or_si512(a, b);
+   }
+#endif
+};
+
+struct AndOp {
+   static uint64_t word(uint64_t a, uint64_t b) { return a & b; }
+#ifdef BITKERNELS_X86
+   TARGET("sse2") static __m128i sse2(__m128i a, __m128i b)
+   {
+      return _mm_and_si128(a, b);
+   }
+   TARGET("avx2") static __m256i avx2(__m256i a, __m256i b)
+   {
+      return _mm256_and_si256(a, b);
+   }
+   TARGET("avx512f") static __m512i avx512(__m512i a, __m512i b)
+   {
+      return _mm512_and_si512(a, b);
+   }
+#endif
+};
+
+// a & ~b (the SSE2/AVX2 intrinsics complement their first operand)
+struct AndNotOp {
+   static uint64_t word(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef BITKERNELS_X86
+   TARGET("sse2") static __m128i sse2(__m128i a, __m128i b)
+   {
+      return _mm_andnot_si128(b, a);
+   }
+   TARGET("avx2") static __m256i avx2(__m256i a, __m256i b)
+   {
+      return _mm256_andnot_si256(b, a);
+   }
+   TARGET("avx512f") static __m512i avx512(__m512i a, __m512i b)
+   {
+      return _mm512_and_si512(a, _mm512_xor_si512(b, _mm512_set1_epi64(-1)));
+   }
+#endif
+};
+
+// --------------------------------------------------------------------------
+// Ways to count the bits of one word. SoftCount adds up bits in parallel
+// with shifts and masks, so it runs anywhere; HardCount is the popcnt
+// instruction, which every x86 level above scalar requires.
+
+struct SoftCount {
+   static int word(uint64_t w)
+   {
+      w -= (w >> 1) & 0x5555555555555555ULL;
+      w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+      w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+      return static_cast<int>((w * 0x0101010101010101ULL) >> 56);
+   }
+};
+
+#ifdef BITKERNELS_X86
+struct HardCount {
+   TARGET("popcnt") static int word(uint64_t w)
+   {
+      return __builtin_popcountll(w);
+   }
+};
+#endif
+
+// --------------------------------------------------------------------------
+// Scalar kernels, used on every platform and (with HardCount) for the tail
+// of vector loops
+
+template<class Op, class Count = SoftCount>
+static long long scalarCombine(uint64_t* dst, const uint64_t* a,
+   const uint64_t* b, int n)
+{
+   long long bits = 0;
+   for (int i = 0; i < n; i++) {
+      dst[i] = Op::word(a[i], b[i]);
+      bits += Count::word(dst[i]);
+   }
+   return bits;
+}
+
+template<class Op, class Count = SoftCount>
+static long long scalarCount(const uint64_t* a, const uint64_t* b, int n)
+{
+   long long bits = 0;
+   for (int i = 0; i < n; i++) {
+      bits += Count::word(Op::word(a[i], b[i]));
+   }
+   return bits;
+}
+
+static bool scalarAnyAnd(const uint64_t* a, const uint64_t* b, int n)
+{
+   for (int i = 0; i < n; i++) {
+      if ((a[i] & b[i]) != 0) return true;
+   }
+   return false;
+}
+
+static bool scalarEqual(const uint64_t* a, const uint64_t* b, int n)
+{
+   for (int i = 0; i < n; i++) {
+      if (a[i] != b[i]) return false;
+   }
+   return true;
+}
+
+template<class Count = SoftCount>
+static long long scalarPopcount(const uint64_t* a, int n)
+{
+   long long bits = 0;
+   for (int i = 0; i < n; i++) {
+      bits += Count::word(a[i]);
+   }
+   return bits;
+}
+
+#ifdef BITKERNELS_X86
+
+// --------------------------------------------------------------------------
+// SSE2 kernels: 128 members per instruction, hardware popcnt per word
+
+template<class Op>
+TARGET("sse2,popcnt") static long long sse2Combine(uint64_t* dst,
+   const uint64_t* a, const uint64_t* b, int n)
+{
+   long long bits = 0;
+   int i = 0;
+   for (; i + 2 <= n; i += 2) {
+      __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Op::sse2(va, vb));
+      bits += HardCount::word(dst[i]) + HardCount::word(dst[i + 1]);
+   }
+   return bits + scalarCombine<Op, HardCount>(dst + i, a + i, b + i, n - i);
+}
+
+template<class Op>
+TARGET("sse2,popcnt") static long long sse2Count(const uint64_t* a,
+   const uint64_t* b, int n)
+{
+   long long bits = 0;
+   for (int i = 0; i < n; i++) {
+      bits += HardCount::word(Op::word(a[i], b[i]));
+   }
+   return bits;
+}
+
+TARGET("sse2") static bool sse2AnyAnd(const uint64_t* a, const uint64_t* b,
+   int n)
+{
+   const __m128i zero = _mm_setzero_si128();
+   int i = 0;
+   for (; i + 2 <= n; i += 2) {
+      __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      __m128i both = _mm_and_si128(va, vb);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(both, zero)) != 0xFFFF)
+         return true;
+   }
+   return scalarAnyAnd(a + i, b + i, n - i);
+}
+
+TARGET("sse2") static bool sse2Equal(const uint64_t* a, const uint64_t* b,
+   int n)
+{
+   int i = 0;
+   for (; i + 2 <= n; i += 2) {
+      __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) return false;
+   }
+   return scalarEqual(a + i, b + i, n - i);
+}
+
+TARGET("sse2,popcnt") static long long sse2Popcount(const uint64_t* a, int n)
+{
+   long long bits = 0;
+   for (int i = 0; i < n; i++) {
+      bits += HardCount::word(a[i]);
+   }
+   return bits;
+}
+
+// --------------------------------------------------------------------------
+// AVX2 kernels: 256 members per instruction. AVX2 has no vector popcount,
+// so bits are counted with a nibble lookup table (vpshufb) and summed into
+// 64-bit lanes with vpsadbw.
+
+TARGET("avx2") static inline __m256i avx2CountBytes(__m256i v)
+{
+   const __m256i table = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+   const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+   __m256i lo = _mm256_and_si256(v, lowNibble);
+   __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+   __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, lo),
+      _mm256_shuffle_epi8(table, hi));
+   return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+TARGET("avx2") static inline long long avx2Sum(__m256i lanes)
+{
+   return _mm256_extract_epi64(lanes, 0) + _mm256_extract_epi64(lanes, 1) +
+      _mm256_extract_epi64(lanes, 2) + _mm256_extract_epi64(lanes, 3);
+}
+
+template<class Op>
+TARGET("avx2") static long long avx2Combine(uint64_t* dst,
+   const uint64_t* a, const uint64_t* b, int n)
+{
+   __m256i counts = _mm256_setzero_si256();
+   int i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      __m256i vd = Op::avx2(va, vb);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), vd);
+      counts = _mm256_add_epi64(counts, avx2CountBytes(vd));
+   }
+   return avx2Sum(counts) +
+      scalarCombine<Op, HardCount>(dst + i, a + i, b + i, n - i);
+}
+
+template<class Op>
+TARGET("avx2") static long long avx2Count(const uint64_t* a,
+   const uint64_t* b, int n)
+{
+   __m256i counts = _mm256_setzero_si256();
+   int i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      counts = _mm256_add_epi64(counts, avx2CountBytes(Op::avx2(va, vb)));
+   }
+   return avx2Sum(counts) + scalarCount<Op, HardCount>(a + i, b + i, n - i);
+}
+
+TARGET("avx2") static bool avx2AnyAnd(const uint64_t* a, const uint64_t* b,
+   int n)
+{
+   int i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      if (!_mm256_testz_si256(va, vb)) return true;
+   }
+   return scalarAnyAnd(a + i, b + i, n - i);
+}
+
+TARGET("avx2") static bool avx2Equal(const uint64_t* a, const uint64_t* b,
+   int n)
+{
+   int i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      __m256i diff = _mm256_xor_si256(va, vb);
+      if (!_mm256_testz_si256(diff, diff)) return false;
+   }
+   return scalarEqual(a + i, b + i, n - i);
+}
+
+TARGET("avx2") static long long avx2Popcount(const uint64_t* a, int n)
+{
+   __m256i counts = _mm256_setzero_si256();
+   int i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+      counts = _mm256_add_epi64(counts, avx2CountBytes(va));
+   }
+   return avx2Sum(counts) + scalarPopcount<HardCount>(a + i, n - i);
+}
+
+// --------------------------------------------------------------------------
+// AVX-512 kernels: 512 members per instruction with vector popcount
+
+TARGET("avx512f") static inline long long avx512Sum(__m512i lanes)
+{
+   uint64_t sums[8];
+   _mm512_storeu_si512(sums, lanes);
+   return sums[0] + sums[1] + sums[2] + sums[3] +
+      sums[4] + sums[5] + sums[6] + sums[7];
+}
+
+template<class Op>
+TARGET("avx512f,avx512vpopcntdq") static long long avx512Combine(
+   uint64_t* dst, const uint64_t* a, const uint64_t* b, int n)
+{
+   __m512i counts = _mm512_setzero_si512();
+   int i = 0;
+   for (; i + 8 <= n; i += 8) {
+      __m512i va = _mm512_loadu_si512(a + i);
+      __m512i vb = _mm512_loadu_si512(b + i);
+      __m512i vd = Op::avx512(va, vb);
+      _mm512_storeu_si512(dst + i, vd);
+      counts = _mm512_add_epi64(counts, _mm512_popcnt_epi64(vd));
+   }
+   return avx512Sum(counts) +
+      scalarCombine<Op, HardCount>(dst + i, a + i, b + i, n - i);
+}
+
+template<class Op>
+TARGET("avx512f,avx512vpopcntdq") static long long avx512Count(
+   const uint64_t* a, const uint64_t* b, int n)
+{
+   __m512i counts = _mm512_setzero_si512();
+   int i = 0;
+   for (; i + 8 <= n; i += 8) {
+      __m512i va = _mm512_loadu_si512(a + i);
+      __m512i vb = _mm512_loadu_si512(b + i);
+      __m512i vd = Op::avx512(va, vb);
+      counts = _mm512_add_epi64(counts, _mm512_popcnt_epi64(vd));
+   }
+   return avx512Sum(counts) +
+      scalarCount<Op, HardCount>(a + i, b + i, n - i);
+}
+
+TARGET("avx512f") static bool avx512AnyAnd(const uint64_t* a,
+   const uint64_t* b, int n)
+{
+   int i = 0;
+   for (; i + 8 <= n; i += 8) {
+      __m512i va = _mm512_loadu_si512(a + i);
+      __m512i vb = _mm512_loadu_si512(b + i);
+      if (_mm512_test_epi64_mask(va, vb) != 0) return true;
+   }
+   return scalarAnyAnd(a + i, b + i, n - i);
+}
+
+TARGET("avx512f") static bool avx512Equal(const uint64_t* a,
+   const uint64_t* b, int n)
+{
+   int i = 0;
+   for (; i + 8 <= n; i += 8) {
+      __m512i va = _mm512_loadu_si512(a + i);
+      __m512i vb = _mm512_loadu_si512(b + i);
+      if (_mm512_cmpneq_epi64_mask(va, vb) != 0) return false;
+   }
+   return scalarEqual(a + i, b + i, n - i);
+}
+
+TARGET("avx512f,avx512vpopcntdq") static long long avx512Popcount(
+   const uint64_t* a, int n)
+{
+   __m512i counts = _mm512_setzero_si512();
+   int i = 0;
+   for (; i + 8 <= n; i += 8) {
+      counts = _mm512_add_epi64(counts,
+         _mm512_popcnt_epi64(_mm512_loadu_si512(a + i)));
+   }
+   return avx512Sum(counts) + scalarPopcount<HardCount>(a + i, n - i);
+}
+
+#endif // BITKERNELS_X86
+
+// --------------------------------------------------------------------------
+// Dispatch table: one set of kernels per level
+
+typedef long long (*CombineKernel)(uint64_t*, const uint64_t*,
+   const uint64_t*, int);
+
+struct KernelTable {
+   KernelIsa isa;
+   CombineKernel orKernel;
+   CombineKernel andKernel;
+   CombineKernel andNotKernel;
+   long long (*andCountKernel)(const uint64_t*, const uint64_t*, int);
+   bool (*anyAndKernel)(const uint64_t*, const uint64_t*, int);
+   bool (*equalKernel)(const uint64_t*, const uint64_t*, int);
+   long long (*popcountKernel)(const uint64_t*, int);
+   int (*popcountWordKernel)(uint64_t);
+};
+
+static const KernelTable TABLES[] = {
+   { ISA_SCALAR, scalarCombine<OrOp>, scalarCombine<AndOp>,
+     scalarCombine<AndNotOp>, scalarCount<AndOp>, scalarAnyAnd, scalarEqual,
+     scalarPopcount<>, SoftCount::word },
+#ifdef BITKERNELS_X86
+   { ISA_SSE2, sse2Combine<OrOp>, sse2Combine<AndOp>,
+     sse2Combine<AndNotOp>, sse2Count<AndOp>, sse2AnyAnd, sse2Equal,
+     sse2Popcount, HardCount::word },
+   { ISA_AVX2, avx2Combine<OrOp>, avx2Combine<AndOp>,
+     avx2Combine<AndNotOp>, avx2Count<AndOp>, avx2AnyAnd, avx2Equal,
+     avx2Popcount, HardCount::word },
+   { ISA_AVX512, avx512Combine<OrOp>, avx512Combine<AndOp>,
+     avx512Combine<AndNotOp>, avx512Count<AndOp>, avx512AnyAnd, avx512Equal,
+     avx512Popcount, HardCount::word },
+#endif
+};
+
+// --------------------------------------------------------------------------
+// isaSupported
+// Returns true if this CPU (and build) can run the given level
+static bool isaSupported(KernelIsa isa)
+{
+   if (isa == ISA_SCALAR) return true;
+#ifdef BITKERNELS_X86
+   __builtin_cpu_init();
+   switch (isa) {
+   case ISA_SSE2:
+      return __builtin_cpu_supports("sse2") && __builtin_cpu_supports("popcnt");
+   case ISA_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+   case ISA_AVX512:
+      return __builtin_cpu_supports("avx512f") &&
+         __builtin_cpu_supports("avx512vpopcntdq") &&
+         __builtin_cpu_supports("popcnt");
+   default:
+      return false;
+   }
+#else
+   return false;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// bestKernelIsa
+// Returns the widest level this CPU supports
+KernelIsa bestKernelIsa()
+{
+   static const KernelIsa best = isaSupported(ISA_AVX512) ? ISA_AVX512
+      : isaSupported(ISA_AVX2) ? ISA_AVX2
+      : isaSupported(ISA_SSE2) ? ISA_SSE2
+      : ISA_SCALAR;
+   return best;
+}
+
+// currently selected table, chosen on first use
+static std::atomic<const KernelTable*> activeTable(nullptr);
+
+// --------------------------------------------------------------------------
+// kernels
+// Returns the active dispatch table, picking the best one on first use
+static const KernelTable* kernels()
+{
+   const KernelTable* table = activeTable.load(std::memory_order_acquire);
+   if (table == nullptr) {
+      table = &TABLES[bestKernelIsa()];
+      activeTable.store(table, std::memory_order_release);
+   }
+   return table;
+}
+
+// --------------------------------------------------------------------------
+// activeKernelIsa
+// Returns the level currently used by the kernels
+KernelIsa activeKernelIsa()
+{
+   return kernels()->isa;
+}
+
+// --------------------------------------------------------------------------
+// setKernelIsa
+// Switches to the given level. Returns false if the CPU does not support it
+bool setKernelIsa(KernelIsa isa)
+{
+   if (!isaSupported(isa)) return false;
+   activeTable.store(&TABLES[isa], std::memory_order_release);
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// kernelIsaName
+// Returns a printable name for a level
+const char* kernelIsaName(KernelIsa isa)
+{
+   switch (isa) {
+   case ISA_SSE2: return "sse2";
+   case ISA_AVX2: return "avx2";
+   case ISA_AVX512: return "avx512";
+   default: return "scalar";
+   }
+}
+
+// --------------------------------------------------------------------------
+// Public kernels: forward to the active table
+
+long long orWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int n)
+{
+   return n > 0 ? kernels()->orKernel(dst, a, b, n) : 0;
+}
+
+long long andWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int n)
+{
+   return n > 0 ? kernels()->andKernel(dst, a, b, n) : 0;
+}
+
+long long andNotWords(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+   int n)
+{
+   return n > 0 ? kernels()->andNotKernel(dst, a, b, n) : 0;
+}
+
+long long andCountWords(const uint64_t* a, const uint64_t* b, int n)
+{
+   return n > 0 ? kernels()->andCountKernel(a, b, n) : 0;
+}
+
+bool anyAndWords(const uint64_t* a, const uint64_t* b, int n)
+{
+   return n > 0 ? kernels()->anyAndKernel(a, b, n) : false;
+}
+
+bool equalWords(const uint64_t* a, const uint64_t* b, int n)
+{
+   return n > 0 ? kernels()->equalKernel(a, b, n) : true;
+}
+
+long long popcountWords(const uint64_t* a, int n)
+{
+   return n > 0 ? kernels()->popcountKernel(a, n) : 0;
+}
+
+int popcountWord(uint64_t w)
+{
+   return kernels()->popcountWordKernel(w);
+}
@@ -0,0 +1,114 @@
+// Created by: Tanvir Tatla
+
+#ifndef BITKERNELS_H
+#define BITKERNELS_H
+#include <cstdint>
+
+//---------------------------------------------------------------------------
+// Bit kernels: loops over arrays of 64-bit words used by IntSet's set
+// algebra. Each kernel has a portable scalar version, and on x86 with GCC or
+// Clang also SSE2, AVX2 and AVX-512 versions. The first kernel call picks the
+// widest version the CPU supports.
+//
+// Implementation and assumptions:
+//   -- dst may be the same array as a (in-place update), but must not
+//      otherwise overlap a or b
+//   -- kernels that write words return the number of set bits written, so
+//      callers can keep a member count without a second pass
+//   -- every level above scalar also needs the popcnt instruction (for
+//      single words and the tails of vector loops); AVX-512 needs the
+//      AVX512F and AVX512-VPOPCNTDQ extensions
+//   -- setKernelIsa forces a narrower level, e.g. to compare levels in a
+//      benchmark
+//   -- popcount64 only uses the popcnt instruction directly when the build
+//      targets it (-mpopcnt or -march=native); otherwise, on x86 it calls
+//      popcountWord, which the dispatch table points at a popcnt version
+//      when the CPU has one, instead of GCC's software fallback
+//---------------------------------------------------------------------------
+
+enum KernelIsa { ISA_SCALAR, ISA_SSE2, ISA_AVX2, ISA_AVX512 };
+
+// widest level this CPU supports
+KernelIsa bestKernelIsa();
+
+// level currently used by the kernels
+KernelIsa activeKernelIsa();
+
+// use the given level from now on. Returns false (and changes nothing) if
+// the CPU does not support it
+bool setKernelIsa(KernelIsa);
+
+// printable name of a level, e.g. "avx2"
+const char* kernelIsaName(KernelIsa);
+
+// dst[i] = a[i] | b[i] for i < n. Returns number of bits set in dst
+long long orWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int n);
+
+// dst[i] = a[i] & b[i] for i < n. Returns number of bits set in dst
+long long andWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int n);
+
+// dst[i] = a[i] & ~b[i] for i < n. Returns number of bits set in dst
+long long andNotWords(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+   int n);
+
+// number of bits set in a[i] & b[i] for i < n, without storing the words
+long long andCountWords(const uint64_t* a, const uint64_t* b, int n);
+
+// true if a[i] & b[i] is not zero for some i < n. Stops at the first
+// vector with a common bit
+bool anyAndWords(const uint64_t* a, const uint64_t* b, int n);
+
+// true if a[i] == b[i] for all i < n
+bool equalWords(const uint64_t* a, const uint64_t* b, int n);
+
+// number of bits set in a[0] through a[n - 1]
+long long popcountWords(const uint64_t* a, int n);
+
+// number of bits set in w, with the active level's instruction
+int popcountWord(uint64_t w);
+
+// --------------------------------------------------------------------------
+// popcount64
+// Returns the number of set bits in w
+inline int popcount64(uint64_t w)
+{
+#if defined(__GNUC__) && (defined(__POPCNT__) || !defined(__x86_64__))
+   return __builtin_popcountll(w);
+#elif defined(__GNUC__)
+   return popcountWord(w);
+#else
+   int bits = 0;
+   for (; w != 0; w &= w - 1) bits++;
+   return bits;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// highestBit64
+// Returns the index of the highest set bit in w (w must not be zero)
+inline int highestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+   return 63 - __builtin_clzll(w);
+#else
+   int bit = 0;
+   while (w >>= 1) bit++;
+   return bit;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// lowestBit64
+// Returns the index of the lowest set bit in w (w must not be zero)
+inline int lowestBit64(uint64_t w)
+{
+#if defined(__GNUC__)
+   return __builtin_ctzll(w);
+#else
+   int bit = 0;
+   while ((w & 1) == 0) { w >>= 1; bit++; }
+   return bit;
+#endif
+}
+
+#endif
@@ -0,0 +1,187 @@
+// Created by: Tanvir Tatla
+
+#include "concurrentintset.h"
+#include "bitkernels.h"
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// number of members held by one word of setPtr
+const int WORD_BITS = 64;
+
+// number of members collected before each insertBatch in toIntSet
+const int COPY_BATCH = 1024;
+
+// ---------------------------------------------------------------------------
+// Constructor
+// Creates an empty set that can hold the integers 0 .. capacity - 1. A
+// negative capacity is treated as zero
+ConcurrentIntSet::ConcurrentIntSet(int capacity)
+{
+   maxCapacity = (capacity > 0) ? capacity : 0;
+   // rounded up without computing maxCapacity + 63, which overflows
+   numWords = maxCapacity / WORD_BITS + (maxCapacity % WORD_BITS != 0);
+
+   setPtr = new atomic<uint64_t>[numWords];
+   for (int i = 0; i < numWords; i++) {
+      setPtr[i].store(0, memory_order_relaxed);
+   }
+
+   void* memory = NULL;
+   size_t bytes = COUNTER_SHARDS * sizeof(Counter);
+#if defined(_WIN32)
+   memory = _aligned_malloc(bytes, alignof(Counter));
+#else
+   if (posix_memalign(&memory, alignof(Counter), bytes) != 0) memory = NULL;
+#endif
+   if (memory == NULL) {
+      delete[] setPtr;
+      throw bad_alloc();
+   }
+
+   counters = static_cast<Counter*>(memory);
+   for (int i = 0; i < COUNTER_SHARDS; i++) {
+      new (&counters[i]) Counter();
+      counters[i].value.store(0, memory_order_relaxed);
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Destructor
+// Destructor for class ConcurrentIntSet. No other thread may be using the
+// set
+ConcurrentIntSet::~ConcurrentIntSet()
+{
+   delete[] setPtr;
+   for (int i = 0; i < COUNTER_SHARDS; i++) counters[i].~Counter();
+#if defined(_WIN32)
+   _aligned_free(counters);
+#else
+   free(counters);
+#endif
+}
+
+// --------------------------------------------------------------------------
+// counterIndex
+// Returns the counter of the calling thread. Threads are handed counters
+// in turn the first time they change any ConcurrentIntSet
+int ConcurrentIntSet::counterIndex()
+{
+   static atomic<int> nextIndex(0);
+   thread_local int index = nextIndex.fetch_add(1, memory_order_relaxed) %
+      COUNTER_SHARDS;
+   return index;
+}
+
+// --------------------------------------------------------------------------
+// insert
+// Returns true if n was added to the set. Returns false if n is negative,
+// not below capacity, or already in the set (possibly added by another
+// thread at the same moment)
+bool ConcurrentIntSet::insert(int n)
+{
+   if (n < 0 || n >= maxCapacity) return false;
+
+   uint64_t bit = uint64_t(1) << (n % WORD_BITS);
+   uint64_t old = setPtr[n / WORD_BITS].fetch_or(bit, memory_order_acq_rel);
+   if (old & bit) return false;
+
+   counters[counterIndex()].value.fetch_add(1, memory_order_relaxed);
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// remove
+// Returns true if n was removed from the set. Returns false if n was not
+// in the set
+bool ConcurrentIntSet::remove(int n)
+{
+   if (n < 0 || n >= maxCapacity) return false;
+
+   uint64_t bit = uint64_t(1) << (n % WORD_BITS);
+   uint64_t old = setPtr[n / WORD_BITS].fetch_and(~bit, memory_order_acq_rel);
+   if (!(old & bit)) return false;
+
+   counters[counterIndex()].value.fetch_sub(1, memory_order_relaxed);
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// isInSet
+// Returns true if n is in the set
+bool ConcurrentIntSet::isInSet(int n) const
+{
+   if (n < 0 || n >= maxCapacity) return false;
+
+   uint64_t word = setPtr[n / WORD_BITS].load(memory_order_acquire);
+   return (word >> (n % WORD_BITS)) & 1;
+}
+
+// --------------------------------------------------------------------------
+// isEmpty
+// Returns true if no word holds a member
+bool ConcurrentIntSet::isEmpty() const
+{
+   for (int i = 0; i < numWords; i++) {
+      if (setPtr[i].load(memory_order_acquire) != 0) return false;
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// size
+// Returns the sum of the per-thread counters. One thread may count an
+// insert that another thread's remove undoes, so a single counter can be
+// negative; only the sum is meaningful
+int ConcurrentIntSet::size() const
+{
+   long long total = 0;
+   for (int i = 0; i < COUNTER_SHARDS; i++) {
+      total += counters[i].value.load(memory_order_relaxed);
+   }
+   return static_cast<int>(total);
+}
+
+// --------------------------------------------------------------------------
+// capacity
+// Returns the number of integers the set can hold
+int ConcurrentIntSet::capacity() const
+{
+   return maxCapacity;
+}
+
+// --------------------------------------------------------------------------
+// toIntSet
+// Returns an IntSet with the members, reading each word once. Changes
+// made by other threads during the copy may or may not be included
+IntSet ConcurrentIntSet::toIntSet() const
+{
+   IntSet result;
+   int buffer[COPY_BATCH];
+   int used = 0;
+
+   for (int i = 0; i < numWords; i++) {
+      uint64_t word = setPtr[i].load(memory_order_acquire);
+      while (word != 0) {
+         buffer[used++] = i * WORD_BITS + lowestBit64(word);
+         word &= word - 1;
+         if (used == COPY_BATCH) {
+            result.insertBatch(buffer, used);
+            used = 0;
+         }
+      }
+   }
+   result.insertBatch(buffer, used);
+
+   return result;
+}
+
+// --------------------------------------------------------------------------
+// operator<<
+// Returns ostream. Displays the members like an IntSet
+ostream& operator<<(ostream& output, const ConcurrentIntSet& set)
+{
+   return output << set.toIntSet();
+}
@@ -0,0 +1,91 @@
+// Created by: Tanvir Tatla
+
+#ifndef CONCURRENTINTSET_H
+#define CONCURRENTINTSET_H
+#include "intset.h"
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// ConcurrentIntSet class:  set of non-negative integers below a capacity
+// fixed at construction that many threads can change at once without a
+// lock. Can:
+//   -- insert and remove integers from a set
+//   -- test whether an integer is in the set
+//   -- count the members
+//   -- copy the members into an IntSet
+//   -- print sets
+//
+// Implementation and assumptions:
+//   -- members are packed 64 to a word like IntSet, but every word is a
+//      std::atomic<uint64_t>; insert is one fetch_or and remove one
+//      fetch_and, and the returned old word tells whether this call made
+//      the change
+//   -- the word array never grows, so no thread ever waits for another;
+//      integers at or above capacity are rejected like negative ones
+//   -- the member count is split over padded per-thread counters so
+//      threads inserting at once do not fight over one cache line. size()
+//      adds them up and is only exact when no other thread is changing the
+//      set
+//   -- a change made by insert or remove is visible to any thread whose
+//      isInSet sees it (release/acquire)
+//   -- objects can not be copied or assigned
+//---------------------------------------------------------------------------
+
+class ConcurrentIntSet
+{
+   friend ostream& operator<<(ostream&, const ConcurrentIntSet&);
+
+public:
+   // set that can hold the integers 0 .. capacity - 1
+   explicit ConcurrentIntSet(int);
+   ~ConcurrentIntSet();
+
+   ConcurrentIntSet(const ConcurrentIntSet &) = delete;
+   ConcurrentIntSet& operator=(const ConcurrentIntSet &) = delete;
+
+   bool insert(int);
+   bool remove(int);
+
+   bool isInSet(int) const;
+   bool isEmpty() const;
+
+   // number of integers in the set
+   int size() const;
+
+   // largest number of distinct integers the set can hold
+   int capacity() const;
+
+   // copy of the members as an ordinary IntSet
+   IntSet toIntSet() const;
+
+private:
+   // number of member counters; a thread always uses the same one
+   static const int COUNTER_SHARDS = 64;
+
+   // counter aligned to and filling a cache line, so neighbours never
+   // share a line. new[] ignores the alignment before C++17, so the
+   // counters are allocated with posix_memalign
+   struct alignas(64) Counter {
+      atomic<long long> value;
+   };
+
+   // number of words in setPtr
+   int numWords;
+
+   // number of integers the set can hold
+   int maxCapacity;
+
+   // pointer to the words that store the set
+   atomic<uint64_t> *setPtr;
+
+   // per-thread share of the member count
+   Counter *counters;
+
+   // counter used by the calling thread
+   static int counterIndex();
+};
+
+#endif
@@ -0,0 +1,198 @@
+// Created by: Tanvir Tatla
+
+#ifndef FIXEDINTSET_H
+#define FIXEDINTSET_H
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// FixedIntSet class:  set of the integers 0 .. N - 1 for a universe known
+// at compile time, e.g. FixedIntSet<24> for hours of the day. Has the same
+// operations as IntSet:
+//   -- unify, intersect, and return the difference of sets
+//   -- allows for the assignment and comparison of sets
+//   -- print sets
+//   -- insert and remove integers from a set
+//
+// Implementation and assumptions:
+//   -- the (N + 63) / 64 words are stored inside the object, so a set
+//      never allocates and one of up to 64 members is a single register
+//   -- integers outside 0 .. N - 1 are rejected like negative ones in
+//      IntSet; bits at or above N are always zero
+//   -- every operation except << is constexpr, so sets can be built and
+//      combined at compile time
+//   -- the words are a plain array: std::array's non-const operator[] is
+//      not constexpr in C++14
+//   -- +, * and - expand to one expression per word (no loop), and ==
+//      or-s the differences of all words before its one branch
+//   -- << prints like IntSet: { 1 5 9}
+//---------------------------------------------------------------------------
+
+template<int N>
+class FixedIntSet
+{
+   static_assert(N > 0, "FixedIntSet needs a universe of at least one");
+
+public:
+   // number of integers the set can hold, and words used to hold them
+   static constexpr int CAPACITY = N;
+   static constexpr int WORDS = (N + 63) / 64;
+
+   // empty set
+   constexpr FixedIntSet() : words{} {}
+
+   // set holding the listed integers; those outside 0 .. N - 1 are ignored
+   constexpr FixedIntSet(initializer_list<int> members) : words{} {
+      for (int n : members) insert(n);
+   }
+
+   constexpr bool insert(int n) {
+      if (n < 0 || n >= N || isInSet(n)) return false;
+      words[n / 64] |= uint64_t(1) << (n % 64);
+      return true;
+   }
+
+   constexpr bool remove(int n) {
+      if (!isInSet(n)) return false;
+      words[n / 64] &= ~(uint64_t(1) << (n % 64));
+      return true;
+   }
+
+   constexpr bool isInSet(int n) const {
+      return n >= 0 && n < N && ((words[n / 64] >> (n % 64)) & 1) != 0;
+   }
+
+   constexpr bool isEmpty() const {
+      for (int i = 0; i < WORDS; i++) {
+         if (words[i] != 0) return false;
+      }
+      return true;
+   }
+
+   // number of integers in the set
+   constexpr int size() const {
+      int total = 0;
+      for (int i = 0; i < WORDS; i++) total += bitCount(words[i]);
+      return total;
+   }
+
+   // mathematical operators
+   constexpr FixedIntSet operator+(const FixedIntSet& set) const {
+      return combine<Or>(set, make_index_sequence<WORDS>());
+   }
+   constexpr FixedIntSet operator*(const FixedIntSet& set) const {
+      return combine<And>(set, make_index_sequence<WORDS>());
+   }
+   constexpr FixedIntSet operator-(const FixedIntSet& set) const {
+      return combine<AndNot>(set, make_index_sequence<WORDS>());
+   }
+
+   // more mathematical operators
+   constexpr FixedIntSet& operator+=(const FixedIntSet& set) {
+      return *this = *this + set;
+   }
+   constexpr FixedIntSet& operator*=(const FixedIntSet& set) {
+      return *this = *this * set;
+   }
+   constexpr FixedIntSet& operator-=(const FixedIntSet& set) {
+      return *this = *this - set;
+   }
+
+   // relational operators
+   constexpr bool operator==(const FixedIntSet& set) const {
+      return equal(set, make_index_sequence<WORDS>());
+   }
+   constexpr bool operator!=(const FixedIntSet& set) const {
+      return !(*this == set);
+   }
+
+   // word i of the set: bit (n % 64) of word (n / 64) is set when n is in
+   // the set
+   constexpr uint64_t word(int i) const { return words[i]; }
+
+   // --------------------------------------------------------------------
+   // operator<<
+   // Returns ostream. Displays integers in set between curly brackets
+   friend ostream& operator<<(ostream& output, const FixedIntSet& set) {
+      output << '{';
+      for (int n = 0; n < N; n++) {
+         if (set.isInSet(n)) output << ' ' << n;
+      }
+      output << '}';
+      return output;
+   }
+
+private:
+   // word operations used by combine
+   struct Or {
+      static constexpr uint64_t apply(uint64_t a, uint64_t b) {
+         return a | b;
+      }
+   };
+   struct And {
+      static constexpr uint64_t apply(uint64_t a, uint64_t b) {
+         return a & b;
+      }
+   };
+   struct AndNot {
+      static constexpr uint64_t apply(uint64_t a, uint64_t b) {
+         return a & ~b;
+      }
+   };
+
+   // words of the set
+   uint64_t words[WORDS];
+
+   // marks the constructor that takes the words themselves
+   struct FromWords {};
+
+   // set made of the given words (exactly WORDS of them)
+   template<class... Words>
+   constexpr FixedIntSet(FromWords, Words... w) : words{ w... } {}
+
+   // --------------------------------------------------------------------
+   // combine
+   // Returns the set whose word i is Op::apply(words[i], set.words[i]),
+   // written out once per word
+   template<class Op, size_t... I>
+   constexpr FixedIntSet combine(const FixedIntSet& set,
+      index_sequence<I...>) const {
+      return FixedIntSet(FromWords(), Op::apply(words[I], set.words[I])...);
+   }
+
+   // --------------------------------------------------------------------
+   // equal
+   // Returns true if every word matches. The differences of all words are
+   // or-ed together, so there is one branch however many words there are
+   template<size_t... I>
+   constexpr bool equal(const FixedIntSet& set, index_sequence<I...>) const {
+      uint64_t diff[] = { (words[I] ^ set.words[I])... };
+      uint64_t any = 0;
+      for (uint64_t d : diff) any |= d;
+      return any == 0;
+   }
+
+   // --------------------------------------------------------------------
+   // bitCount
+   // Returns the number of set bits in w; a builtin call where the
+   // compiler provides one, since both work at compile time
+   static constexpr int bitCount(uint64_t w) {
+#if defined(__GNUC__)
+      return __builtin_popcountll(w);
+#else
+      w = w - ((w >> 1) & 0x5555555555555555ULL);
+      w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+      w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+      return static_cast<int>((w * 0x0101010101010101ULL) >> 56);
+#endif
+   }
+};
+
+template<int N> constexpr int FixedIntSet<N>::CAPACITY;
+template<int N> constexpr int FixedIntSet<N>::WORDS;
+
+#endif
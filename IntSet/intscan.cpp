@@ -0,0 +1,67 @@
+// Created by: Tanvir Tatla
+
+#include "intscan.h"
+#include "bitkernels.h"
+#include <climits>
+#include <cstring>
+
+// --------------------------------------------------------------------------
+// eightDigits
+// Returns the value of the first len (1 to 8) decimal digits packed in
+// digits, which holds the characters minus '0', first character in the
+// lowest byte. The digits are shifted to the top bytes (the rest become
+// leading zeros) and combined in three multiplies
+static inline uint64_t eightDigits(uint64_t digits, int len)
+{
+   uint64_t v = digits << (8 * (8 - len));
+   v = ((v & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+   v = ((v & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+   return ((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+}
+
+// --------------------------------------------------------------------------
+// scanInts
+// Parses integers from text at p (see intscan.h). On little-endian machines
+// digits are found and converted 8 characters at a time
+int scanInts(const char*& p, const char* start, const char* end,
+   int* values, int max)
+{
+   const uint64_t ONES = 0x0101010101010101ULL;
+   int n = 0;
+
+   while (n < max) {
+      while (p < end && !isDigit(*p)) p++;
+      if (p == end) break;
+
+      bool negative = p > start && p[-1] == '-';
+      uint64_t value = 0;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      // a byte of digits is below 10 only where the text has a digit
+      static const uint64_t POWERS[9] = { 1, 10, 100, 1000, 10000, 100000,
+         1000000, 10000000, 100000000 };
+      while (end - p >= 8) {
+         uint64_t digits;
+         memcpy(&digits, p, 8);
+         digits ^= 0x30 * ONES;
+         uint64_t other = (((digits & 0x7F * ONES) + 0x76 * ONES) | digits) &
+            0x80 * ONES;
+         int len = (other != 0) ? lowestBit64(other) / 8 : 8;
+
+         if (len > 0 && value <= INT_MAX)
+            value = value * POWERS[len] + eightDigits(digits, len);
+         p += len;
+         if (len < 8) break;
+      }
+#endif
+
+      // the last few characters, one at a time
+      for (; p < end && isDigit(*p); p++) {
+         if (value <= INT_MAX) value = value * 10 + (*p - '0');
+      }
+
+      if (!negative && value <= INT_MAX) values[n++] = static_cast<int>(value);
+   }
+
+   return n;
+}
@@ -0,0 +1,32 @@
+// Created by: Tanvir Tatla
+
+#ifndef INTSCAN_H
+#define INTSCAN_H
+
+//---------------------------------------------------------------------------
+// Integer scanner shared by the >> operators and text input of IntSet and
+// SparseIntSet, so both read a line the same way.
+//
+// Implementation and assumptions:
+//   -- like >>, only non-negative integers that fit in an int are kept:
+//      digits right after a '-' are a negative number and skipped, as are
+//      digit runs too large for an int and every other character
+//   -- the text does not need a terminating '\0'; scanning stops at end
+//---------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// isDigit
+// Returns true if c is '0' through '9'
+inline bool isDigit(char c)
+{
+   return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Parses integers from text at p, stopping at end or once max values are
+// stored in values, and leaves p just past the last character read. start
+// is the beginning of the text, so the character before a number can be
+// checked. Returns number of values stored
+int scanInts(const char*& p, const char* start, const char* end,
+   int* values, int max);
+
+#endif
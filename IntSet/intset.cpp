@@ -1,18 +1,68 @@
 // Created by: Tanvir Tatla
 
 #include "intset.h"
+#include "bitkernels.h"
+#include "intscan.h"
+#include "intsetstats.h"
+#include "workerpool.h"
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define INTSET_NO_MMAP 1
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 const int INIT_SIZE = 5;
 
+// number of members held by one word of setPtr
+const int WORD_BITS = 64;
+
+// number of words covered by one rank directory entry
+const int RANK_BLOCK_WORDS = 8;
+
+// bytes read from a stream at a time by insertText
+const int TEXT_BLOCK = 1 << 20;
+
+// number of words in one chunk of a parallel operation, sized so a chunk
+// of each input and of the result fit in a core's L2 cache together
+const int PARALLEL_CHUNK_WORDS = 16384;
+
+// binary file header, followed by the words up to maxNum's word. 32 bytes,
+// so the words stay 8-byte aligned in a mapped file
+struct BinaryHeader {
+   char magic[4];     // "ISET"
+   uint32_t version;  // BINARY_VERSION
+   int32_t maxNum;    // largest member, -1 if empty
+   int32_t count;     // number of members
+   int64_t words;     // number of words that follow
+   uint64_t reserved; // zero
+};
+
+const char BINARY_MAGIC[4] = { 'I', 'S', 'E', 'T' };
+const uint32_t BINARY_VERSION = 1;
 
 // ---------------------------------------------------------------------------
-// Constructor 
+// Constructor
 // Default constructor for class IntSet
 IntSet::IntSet(int a, int b, int c, int d, int e)
 {
-   // initialize maxNum and count to zero.
-   maxNum = 0;
+   // initialize maxNum to -1 (no members) and count to zero.
+   maxNum = -1;
    count = 0;
+   rankDir = NULL;
+   rankDirValid = false;
+   mapBase = NULL;
+   mapLength = 0;
 
    // place parameters into array
    int numbers[] = { a, b, c, d, e };
@@ -23,20 +73,20 @@ IntSet::IntSet(int a, int b, int c, int d, int e)
          maxNum = numbers[i];
    }
 
-   // initialize size and allocate for bool array
-   size = maxNum + 1;
-   setPtr = new bool[size];
-
-   // initialize setPtr to false
-   for (int i = 0; i < size; i++) {
-      setPtr[i] = false;
+   // initialize numWords and allocate zeroed word array; an empty set
+   // allocates nothing
+   numWords = wordsFor(maxNum);
+   setPtr = (numWords > 0) ? newWords(numWords) : NULL;
+   for (int i = 0; i < numWords; i++) {
+      setPtr[i] = 0;
    }
 
-   // add parameters to set if non-negative
+   // add parameters to set if non-negative and not a duplicate
    for (int i = 0; i < INIT_SIZE; i++) {
-      if (numbers[i] >= 0)
+      if (numbers[i] >= 0 && !isInSet(numbers[i]))
       {
-         setPtr[numbers[i]] = true;
+         setPtr[numbers[i] / WORD_BITS] |=
+            uint64_t(1) << (numbers[i] % WORD_BITS);
          count++;
       }
    }
@@ -46,69 +96,193 @@ IntSet::IntSet(int a, int b, int c, int d, int e)
 // Copy constructor for class IntSet
 IntSet::IntSet(const IntSet& original)
 {
-   size = original.size;
-   setPtr = new bool[size];
+   INTSET_STATS_OP(STAT_COPY);
 
-   // copy original values to new set
-   for (int i = 0; i < size; i++) {
+   // only the words that can hold members are copied
+   numWords = original.usedWords();
+   setPtr = (numWords > 0) ? newWords(numWords) : NULL;
+
+   // copy original words to new set
+   for (int i = 0; i < numWords; i++) {
       setPtr[i] = original.setPtr[i];
    }
 
    maxNum = original.maxNum;
    count = original.count;
+   rankDir = NULL;
+   rankDirValid = false;
+   mapBase = NULL;
+   mapLength = 0;
 }
 
 // ---------------------------------------------------------------------------
-// Destructor 
+// Move constructor for class IntSet
+// Takes over original's word array and leaves original an empty set
+IntSet::IntSet(IntSet&& original) noexcept
+{
+   numWords = original.numWords;
+   setPtr = original.setPtr;
+   maxNum = original.maxNum;
+   count = original.count;
+   rankDir = original.rankDir;
+   rankDirValid = original.rankDirValid;
+   mapBase = original.mapBase;
+   mapLength = original.mapLength;
+
+   original.numWords = 0;
+   original.setPtr = NULL;
+   original.maxNum = -1;
+   original.count = 0;
+   original.rankDir = NULL;
+   original.rankDirValid = false;
+   original.mapBase = NULL;
+   original.mapLength = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Destructor
 // Destructor for class IntSet
 IntSet::~IntSet()
 {
+   releaseWords();
+   delete[] rankDir;
+   rankDir = NULL;
+}
+
+// --------------------------------------------------------------------------
+// wordsFor
+// Returns the number of words needed to hold the integers 0 through n
+// (zero words if n is negative)
+int IntSet::wordsFor(int n)
+{
+   return (n < 0) ? 0 : n / WORD_BITS + 1;
+}
+
+// --------------------------------------------------------------------------
+// usedWords
+// Returns the number of words that can contain members. Words past this
+// point are always zero.
+int IntSet::usedWords() const
+{
+   return wordsFor(maxNum);
+}
+
+// --------------------------------------------------------------------------
+// newWords
+// Returns a new uninitialized array of n words, counted by the statistics
+uint64_t* IntSet::newWords(int n)
+{
+   INTSET_STATS_ALLOC(static_cast<long long>(n) * sizeof(uint64_t));
+   return new uint64_t[n];
+}
+
+// --------------------------------------------------------------------------
+// reserveWords
+// Grows the word array so it holds at least words words. New words are zero.
+void IntSet::reserveWords(int words)
+{
+   if (words <= numWords) return;
+
+   uint64_t *temp = newWords(words);
+   if (setPtr != NULL)
+      INTSET_STATS_RESIZE(static_cast<long long>(numWords) * sizeof(uint64_t));
+
+   // copy old words, zero the rest
+   for (int i = 0; i < numWords; i++) {
+      temp[i] = setPtr[i];
+   }
+   for (int i = numWords; i < words; i++) {
+      temp[i] = 0;
+   }
+
+   releaseWords();
+   setPtr = temp;
+   numWords = words;
+}
+
+// --------------------------------------------------------------------------
+// releaseWords
+// Frees the word array, or unmaps the file if this set is a view
+void IntSet::releaseWords()
+{
+   if (setPtr != NULL && mapBase == NULL)
+      INTSET_STATS_FREE(static_cast<long long>(numWords) * sizeof(uint64_t));
+
+#ifndef INTSET_NO_MMAP
+   if (mapBase != NULL) munmap(mapBase, mapLength);
+   else delete[] setPtr;
+#else
    delete[] setPtr;
+#endif
+
    setPtr = NULL;
+   mapBase = NULL;
+   mapLength = 0;
 }
 
 // --------------------------------------------------------------------------
-// insert
-// Return true if n is successfully inserted and false if unsuccessful
-bool IntSet::insert(int n)
+// makeOwned
+// Copies a view's words into a word array this set owns, so it can be
+// changed. Does nothing for an ordinary set
+void IntSet::makeOwned()
 {
-   // if int to be inserted is non-negative AND can be inserted into array 
-   // without resizing AND does not already exist in set.
-   if (n >= 0 && n < size && !isInSet(n)) {
-      // insert and find new maxNum
-      setPtr[n] = true;
-      count++;
-      maxNum = (n > maxNum) ? n : maxNum;
-      return true;
-   }
+   if (mapBase == NULL) return;
 
-   // else if bool array needs to be resized
-   else if (n >= size) {
-      // create new array
-      size = n + 1;
-      bool *temp = new bool[size];
+   uint64_t *temp = newWords(numWords);
+   memcpy(temp, setPtr, numWords * sizeof(uint64_t));
 
-      // loop over new array to initialize it
-      for (int i = 0; i < n; i++) {
-         // copy ints from old array into new array
-         if (i <= maxNum && setPtr[i])
-            temp[i] = true;
-         else
-            temp[i] = false;
-      }
+   releaseWords();
+   setPtr = temp;
+}
 
-      // insert n (parameter) into new array
-      temp[n] = true;
-      count++;
-      delete[] setPtr;
-      setPtr = temp;
-      maxNum = n;
+// --------------------------------------------------------------------------
+// growFor
+// Grows the word array if n does not fit, at least doubling it so a run of
+// ascending inserts only copies the array O(log n) times
+void IntSet::growFor(int n)
+{
+   if (n / WORD_BITS < numWords) return;
 
-      return true;
+   int words = wordsFor(n);
+   int doubled = (numWords > INT_MAX / 2) ? INT_MAX : 2 * numWords;
+   reserveWords((words > doubled) ? words : doubled);
+}
+
+// --------------------------------------------------------------------------
+// findMaxNum
+// Sets maxNum to the highest member at or below word index from, or -1 if
+// there is none
+void IntSet::findMaxNum(int from)
+{
+   for (int w = from; w >= 0; w--) {
+      if (setPtr[w] != 0) {
+         maxNum = w * WORD_BITS + highestBit64(setPtr[w]);
+         return;
+      }
    }
 
-   // return false if n was invalid or already existed in set
-   else return false;
+   maxNum = -1;
+}
+
+// --------------------------------------------------------------------------
+// insert
+// Return true if n is successfully inserted and false if unsuccessful
+bool IntSet::insert(int n)
+{
+   INTSET_STATS_OP(STAT_INSERT);
+   // ignore negative integers and integers already in the set
+   if (n < 0 || isInSet(n)) return false;
+   makeOwned();
+
+   // grow word array if n does not fit
+   growFor(n);
+
+   // insert and find new maxNum
+   setPtr[n / WORD_BITS] |= uint64_t(1) << (n % WORD_BITS);
+   count++;
+   rankDirValid = false;
+   maxNum = (n > maxNum) ? n : maxNum;
+   return true;
 }
 
 // --------------------------------------------------------------------------
@@ -116,25 +290,16 @@ bool IntSet::insert(int n)
 // Return true if n is successfully removed and false if unsuccessful
 bool IntSet::remove(int n)
 {
+   INTSET_STATS_OP(STAT_REMOVE);
    // if n exists in set
    if (isInSet(n)) {
-      setPtr[n] = false;
+      makeOwned();
+      setPtr[n / WORD_BITS] &= ~(uint64_t(1) << (n % WORD_BITS));
       count--;
+      rankDirValid = false;
 
-      // if n was maxNum, then find new maxNum
-      if (n == maxNum) {
-         // loop over array from n to zero
-         for (int i = n; i >= 0; i--) {
-            if (setPtr[i])
-            {
-               maxNum = i;
-               break;
-            }
-
-            // if set has no numbers, then set maxNum to -1
-            else maxNum = -1;
-         }
-      }
+      // if n was maxNum, then find new maxNum (-1 if set is now empty)
+      if (n == maxNum) findMaxNum(n / WORD_BITS);
 
       return true;
    }
@@ -143,13 +308,218 @@ bool IntSet::remove(int n)
    else return false;
 }
 
+// --------------------------------------------------------------------------
+// insertBatch
+// Inserts n integers from values, sizing the word array once for the
+// largest. Returns number of integers that were not already in the set
+int IntSet::insertBatch(const int* values, int n)
+{
+   INTSET_STATS_OP(STAT_INSERT_BATCH);
+   int largest = -1;
+   for (int i = 0; i < n; i++) {
+      largest = (values[i] > largest) ? values[i] : largest;
+   }
+   if (largest < 0) return 0;
+   makeOwned();
+   growFor(largest);
+
+   // set each bit, counting the ones that were clear
+   int inserted = 0;
+   for (int i = 0; i < n; i++) {
+      int v = values[i];
+      if (v < 0) continue;
+      uint64_t bit = uint64_t(1) << (v % WORD_BITS);
+      uint64_t& word = setPtr[v / WORD_BITS];
+      inserted += (word & bit) == 0;
+      word |= bit;
+   }
+
+   count += inserted;
+   maxNum = (largest > maxNum) ? largest : maxNum;
+   rankDirValid = false;
+   return inserted;
+}
+
+// --------------------------------------------------------------------------
+// insertText
+// Inserts every integer in length characters of text, parsed as >> would
+// (negative numbers and other characters are skipped), a batch at a time.
+// Returns number of integers inserted
+int IntSet::insertText(const char* text, size_t length)
+{
+   INTSET_STATS_OP(STAT_INSERT_TEXT);
+   const char* p = text;
+   const char* end = text + length;
+   int values[BATCH_SIZE];
+   int inserted = 0;
+
+   while (p < end) {
+      int n = scanInts(p, text, end, values, BATCH_SIZE);
+      inserted += insertBatch(values, n);
+   }
+
+   return inserted;
+}
+
+// --------------------------------------------------------------------------
+// insertText
+// Inserts every integer in the rest of a stream, reading it in large
+// blocks. A number cut off at the end of a block is carried, with the
+// character before it, to the front of the next one; a block ending in
+// anything else carries its last character, so a '-' there still makes
+// the next block's first number negative. Returns number of integers
+// inserted
+int IntSet::insertText(istream& input)
+{
+   vector<char> buffer(TEXT_BLOCK);
+   size_t carried = 0;
+   int inserted = 0;
+
+   while (true) {
+      input.read(&buffer[carried], buffer.size() - carried);
+      size_t length = carried + static_cast<size_t>(input.gcount());
+      bool last = !input;
+
+      // hold back a digit run that reaches the end of the block and the
+      // character before it, or just the last character (which may be a
+      // '-' for digits at the start of the next block)
+      size_t cut = length;
+      if (!last) {
+         while (cut > 0 && isDigit(buffer[cut - 1])) cut--;
+         if (cut > 0) cut--;
+      }
+
+      inserted += insertText(&buffer[0], cut);
+      if (last) break;
+
+      carried = length - cut;
+      memmove(&buffer[0], &buffer[cut], carried);
+
+      // a block of nothing but digits: make room for more
+      if (carried == buffer.size()) buffer.resize(2 * buffer.size());
+   }
+
+   return inserted;
+}
+
+// --------------------------------------------------------------------------
+// insertTextFile
+// Inserts every integer in a text file, parsing the mapped file in place
+// (or read in blocks where mmap is not available). Returns false if the
+// file can not be opened
+bool IntSet::insertTextFile(const char* path)
+{
+#ifndef INTSET_NO_MMAP
+   int fd = open(path, O_RDONLY);
+   if (fd < 0) return false;
+
+   struct stat info;
+   if (fstat(fd, &info) != 0) {
+      close(fd);
+      return false;
+   }
+
+   size_t length = static_cast<size_t>(info.st_size);
+   if (length == 0) {
+      close(fd);
+      return true;
+   }
+
+   void* base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (base == MAP_FAILED) return false;
+
+   madvise(base, length, MADV_SEQUENTIAL);
+   insertText(static_cast<const char*>(base), length);
+   munmap(base, length);
+   return true;
+#else
+   ifstream file(path, ios::binary);
+   if (!file) return false;
+   insertText(file);
+   return true;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// removeBatch
+// Removes n integers given in values, then finds the new maxNum once.
+// Returns number of integers that were in the set
+int IntSet::removeBatch(const int* values, int n)
+{
+   INTSET_STATS_OP(STAT_REMOVE_BATCH);
+   makeOwned();
+
+   // clear each bit, counting the ones that were set
+   int removed = 0;
+   for (int i = 0; i < n; i++) {
+      int v = values[i];
+      if (v < 0 || v > maxNum) continue;
+      uint64_t bit = uint64_t(1) << (v % WORD_BITS);
+      uint64_t& word = setPtr[v / WORD_BITS];
+      removed += (word & bit) != 0;
+      word &= ~bit;
+   }
+
+   if (removed > 0) {
+      count -= removed;
+      findMaxNum(usedWords() - 1);
+      rankDirValid = false;
+   }
+   return removed;
+}
+
+// --------------------------------------------------------------------------
+// insertRange
+// Inserts every integer from lo through hi (inclusive). Negative integers
+// are skipped. Returns number of integers that were not already in the set
+int IntSet::insertRange(int lo, int hi)
+{
+   INTSET_STATS_OP(STAT_INSERT_RANGE);
+   lo = (lo < 0) ? 0 : lo;
+   if (hi < lo) return 0;
+   makeOwned();
+   growFor(hi);
+
+   int firstWord = lo / WORD_BITS;
+   int lastWord = hi / WORD_BITS;
+   uint64_t firstMask = ~uint64_t(0) << (lo % WORD_BITS);
+   uint64_t lastMask = ~uint64_t(0) >> (WORD_BITS - 1 - hi % WORD_BITS);
+   int inserted = 0;
+
+   // partial first and last words
+   if (firstWord == lastWord) firstMask &= lastMask;
+   inserted += popcount64(firstMask & ~setPtr[firstWord]);
+   setPtr[firstWord] |= firstMask;
+   if (lastWord != firstWord) {
+      inserted += popcount64(lastMask & ~setPtr[lastWord]);
+      setPtr[lastWord] |= lastMask;
+   }
+
+   // whole words in between: count the members they had with the kernel,
+   // then fill them
+   int middle = lastWord - firstWord - 1;
+   if (middle > 0) {
+      inserted += static_cast<int>(static_cast<long long>(middle) *
+         WORD_BITS - popcountWords(setPtr + firstWord + 1, middle));
+      for (int w = firstWord + 1; w < lastWord; w++) {
+         setPtr[w] = ~uint64_t(0);
+      }
+   }
+
+   count += inserted;
+   maxNum = (hi > maxNum) ? hi : maxNum;
+   rankDirValid = false;
+   return inserted;
+}
+
 // --------------------------------------------------------------------------
 // isInSet
 // Return true if n is in the set or false if not in set
 bool IntSet::isInSet(int n) const
 {
    if (n < 0 || n > maxNum) return false;
-   return setPtr[n];
+   return (setPtr[n / WORD_BITS] >> (n % WORD_BITS)) & 1;
 }
 
 // --------------------------------------------------------------------------
@@ -161,77 +531,317 @@ bool IntSet::isEmpty() const
 }
 
 // --------------------------------------------------------------------------
-// operator+
+// size
+// Returns the number of integers in the set
+int IntSet::size() const
+{
+   return count;
+}
+
+// --------------------------------------------------------------------------
+// begin, end, rbegin, rend
+// Iterators over the members. end() (and rend()) is the position after the
+// last member visited
+IntSet::const_iterator IntSet::begin() const
+{
+   return const_iterator(this, nextMember(0));
+}
+
+IntSet::const_iterator IntSet::end() const
+{
+   return const_iterator(this, -1);
+}
+
+IntSet::const_reverse_iterator IntSet::rbegin() const
+{
+   return const_reverse_iterator(end());
+}
+
+IntSet::const_reverse_iterator IntSet::rend() const
+{
+   return const_reverse_iterator(begin());
+}
+
+// --------------------------------------------------------------------------
+// nextMember
+// Returns the smallest member at or above n, or -1 if there is none
+int IntSet::nextMember(int n) const
+{
+   if (n < 0) n = 0;
+   if (n > maxNum) return -1;
+
+   // bits of n's word at or above n, then whole words until a member shows
+   int w = n / WORD_BITS;
+   uint64_t bits = setPtr[w] & (~uint64_t(0) << (n % WORD_BITS));
+   while (bits == 0) {
+      if (++w >= usedWords()) return -1;
+      bits = setPtr[w];
+   }
+
+   return w * WORD_BITS + lowestBit64(bits);
+}
+
+// --------------------------------------------------------------------------
+// prevMember
+// Returns the largest member at or below n, or -1 if there is none
+int IntSet::prevMember(int n) const
+{
+   if (n > maxNum) n = maxNum;
+   if (n < 0) return -1;
+
+   // bits of n's word at or below n, then whole words down to word 0
+   int w = n / WORD_BITS;
+   uint64_t mask = ~uint64_t(0) >> (WORD_BITS - 1 - n % WORD_BITS);
+   uint64_t bits = setPtr[w] & mask;
+   while (bits == 0) {
+      if (--w < 0) return -1;
+      bits = setPtr[w];
+   }
+
+   return w * WORD_BITS + highestBit64(bits);
+}
+
+// --------------------------------------------------------------------------
+// buildRankDir
+// Rebuilds the rank directory from the words if the set has changed since
+// it was last built. Directory has one entry per block of RANK_BLOCK_WORDS
+// words plus a final entry holding count
+void IntSet::buildRankDir() const
+{
+   if (rankDirValid) return;
+
+   int blocks = (usedWords() + RANK_BLOCK_WORDS - 1) / RANK_BLOCK_WORDS;
+   delete[] rankDir;
+   rankDir = new int[blocks + 1];
+
+   // running total of members before each block
+   int total = 0;
+   for (int b = 0; b < blocks; b++) {
+      rankDir[b] = total;
+      int first = b * RANK_BLOCK_WORDS;
+      int words = (usedWords() - first < RANK_BLOCK_WORDS)
+         ? usedWords() - first : RANK_BLOCK_WORDS;
+      total += popcountWords(setPtr + first, words);
+   }
+   rankDir[blocks] = total;
+
+   rankDirValid = true;
+}
+
+// --------------------------------------------------------------------------
+// rank
+// Returns the number of integers in the set that are less than n
+int IntSet::rank(int n) const
+{
+   INTSET_STATS_OP(STAT_RANK);
+   if (n <= 0 || count == 0) return 0;
+   if (n > maxNum) return count;
+
+   buildRankDir();
+
+   // members in earlier blocks, then earlier words of n's block, then the
+   // bits of n's word below n
+   int w = n / WORD_BITS;
+   int block = w / RANK_BLOCK_WORDS;
+   int result = rankDir[block];
+   result += popcountWords(setPtr + block * RANK_BLOCK_WORDS,
+      w - block * RANK_BLOCK_WORDS);
+   uint64_t below = (uint64_t(1) << (n % WORD_BITS)) - 1;
+   return result + popcount64(setPtr[w] & below);
+}
+
+// --------------------------------------------------------------------------
+// select
+// Returns the k-th smallest integer in the set (k = 0 is the smallest), or
+// -1 if there is no such integer
+int IntSet::select(int k) const
+{
+   INTSET_STATS_OP(STAT_SELECT);
+   if (k < 0 || k >= count) return -1;
+
+   buildRankDir();
+
+   // binary search for the last block with fewer than k + 1 members before it
+   int blocks = (usedWords() + RANK_BLOCK_WORDS - 1) / RANK_BLOCK_WORDS;
+   int low = 0;
+   int high = blocks - 1;
+   while (low < high) {
+      int mid = (low + high + 1) / 2;
+      if (rankDir[mid] <= k) low = mid;
+      else high = mid - 1;
+   }
+
+   // walk the words of that block until the k-th member's word is found
+   k -= rankDir[low];
+   int w = low * RANK_BLOCK_WORDS;
+   for (int bits = popcount64(setPtr[w]); k >= bits;
+      bits = popcount64(setPtr[w])) {
+      k -= bits;
+      w++;
+   }
+
+   // drop the k lowest members of the word, the k-th member is then lowest
+   uint64_t word = setPtr[w];
+   for (int i = 0; i < k; i++) {
+      word &= word - 1;
+   }
+   return w * WORD_BITS + lowestBit64(word);
+}
+
+// --------------------------------------------------------------------------
+// unionWith
 // Returns union of two IntSets
-IntSet IntSet::operator+(const IntSet& set) const
+IntSet IntSet::unionWith(const IntSet& set) const
 {
+   INTSET_STATS_OP(STAT_UNION);
    IntSet temp;
 
-   int max = (maxNum > set.maxNum) ? maxNum : set.maxNum;
-
-   // loop over larger IntSet
-   for (int i = 0; i <= max; i++) {
-      // inserts whenever either set contains a number
-      if (isInSet(i) || set.isInSet(i))
-         temp.insert(i);
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords > setWords) ? thisWords : setWords;
+   int common = (thisWords < setWords) ? thisWords : setWords;
+   temp.reserveWords(words);
+
+   // or together the words both sets have, then copy the rest of the
+   // longer set, counting members as we go
+   const IntSet& longer = (thisWords > setWords) ? *this : set;
+   temp.count = orWords(temp.setPtr, setPtr, set.setPtr, common);
+   for (int i = common; i < words; i++) {
+      temp.setPtr[i] = longer.setPtr[i];
    }
+   temp.count += popcountWords(temp.setPtr + common, words - common);
+
+   temp.maxNum = (maxNum > set.maxNum) ? maxNum : set.maxNum;
+   if (temp.count == 0) temp.maxNum = -1;
 
    return temp;
 }
 
 // --------------------------------------------------------------------------
-// operator*
+// intersectionWith
 // Returns intersection of two IntSets
-IntSet IntSet::operator*(const IntSet& set) const
+IntSet IntSet::intersectionWith(const IntSet& set) const
 {
+   INTSET_STATS_OP(STAT_INTERSECTION);
    IntSet temp;
 
-   int smallMax = (maxNum < set.maxNum) ? maxNum : set.maxNum;
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords < setWords) ? thisWords : setWords;
+   temp.reserveWords(words);
 
-   // loop over smaller IntSet
-   for (int i = 0; i <= smallMax; i++) {
-      // insert whenever both sets contain the same number
-      if (isInSet(i) && set.isInSet(i))
-         temp.insert(i);
-   }
+   // and together the words both sets have, counting members as we go
+   temp.count = andWords(temp.setPtr, setPtr, set.setPtr, words);
+
+   temp.findMaxNum(words - 1);
 
    return temp;
 }
 
 // --------------------------------------------------------------------------
-// operator-
+// differenceWith
 // Returns difference of two IntSets
-IntSet IntSet::operator-(const IntSet& set) const
+IntSet IntSet::differenceWith(const IntSet& set) const
 {
+   INTSET_STATS_OP(STAT_DIFFERENCE);
    IntSet copy(*this);
-
-   // loop over 2nd IntSet (parameter)
-   for (int i = 0; i <= set.maxNum; i++) {
-      // remove whenever both sets contain the same number
-      if (copy.isInSet(i) && set.isInSet(i))
-         copy.remove(i);
-   }
+   copy -= set;
 
    return copy;
 }
 
+// --------------------------------------------------------------------------
+// assignExpr
+// Replaces the set with the union of two sets (c = a + b)
+void IntSet::assignExpr(const IntSetExpr<UnionOp, IntSetLeaf,
+   IntSetLeaf>& expr)
+{
+   *this = expr.leftOperand().operand().unionWith(
+      expr.rightOperand().operand());
+}
+
+// --------------------------------------------------------------------------
+// assignExpr
+// Replaces the set with the intersection of two sets (c = a * b)
+void IntSet::assignExpr(const IntSetExpr<IntersectionOp, IntSetLeaf,
+   IntSetLeaf>& expr)
+{
+   *this = expr.leftOperand().operand().intersectionWith(
+      expr.rightOperand().operand());
+}
+
+// --------------------------------------------------------------------------
+// assignExpr
+// Replaces the set with the difference of two sets (c = a - b)
+void IntSet::assignExpr(const IntSetExpr<DifferenceOp, IntSetLeaf,
+   IntSetLeaf>& expr)
+{
+   *this = expr.leftOperand().operand().differenceWith(
+      expr.rightOperand().operand());
+}
+
 // --------------------------------------------------------------------------
 // operator=
 // Assigns/sets value of right side operand (param) to left side (this)
-IntSet IntSet::operator=(const IntSet& set) 
+IntSet& IntSet::operator=(const IntSet& set)
 {
+   INTSET_STATS_OP(STAT_ASSIGN);
    // check if this and parameter are the same
    if (&set != this) {
-      delete[] setPtr;
-      size = set.size;
-      setPtr = new bool[size];
+      int words = set.usedWords();
+      int oldWords = usedWords();
+
+      // reuse the word array when it is big enough (and not a view)
+      if (words > numWords || mapBase != NULL) {
+         releaseWords();
+         oldWords = 0;
+         numWords = words;
+         setPtr = newWords(numWords);
+      }
 
-      for (int i = 0; i < size; i++) {
+      for (int i = 0; i < words; i++) {
          setPtr[i] = set.setPtr[i];
       }
 
+      // clear words that held members before but are past the new maxNum
+      for (int i = words; i < oldWords; i++) {
+         setPtr[i] = 0;
+      }
+
+      maxNum = set.maxNum;
+      count = set.count;
+      rankDirValid = false;
+   }
+
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// operator= (move)
+// Takes over the right side operand's word array; the operand is left empty
+IntSet& IntSet::operator=(IntSet&& set) noexcept
+{
+   if (&set != this) {
+      releaseWords();
+      delete[] rankDir;
+
+      numWords = set.numWords;
+      setPtr = set.setPtr;
       maxNum = set.maxNum;
       count = set.count;
+      rankDir = set.rankDir;
+      rankDirValid = set.rankDirValid;
+      mapBase = set.mapBase;
+      mapLength = set.mapLength;
+
+      set.numWords = 0;
+      set.setPtr = NULL;
+      set.maxNum = -1;
+      set.count = 0;
+      set.rankDir = NULL;
+      set.rankDirValid = false;
+      set.mapBase = NULL;
+      set.mapLength = 0;
    }
 
    return *this;
@@ -240,39 +850,69 @@ IntSet IntSet::operator=(const IntSet& set)
 // --------------------------------------------------------------------------
 // operator+=
 // Returns unification of right and left operands and assigns result to left
-IntSet IntSet::operator+=(const IntSet& set)
+IntSet& IntSet::operator+=(const IntSet& set)
 {
-   for (int i = 0; i <= set.maxNum; i++) {
-      if (set.isInSet(i))
-         insert(i);
-   }
+   INTSET_STATS_OP(STAT_UNION_ASSIGN);
+   makeOwned();
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   reserveWords(setWords);
+
+   // or the parameter's words into this set's words; words past the end of
+   // the parameter keep their members
+   count = orWords(setPtr, setPtr, set.setPtr, setWords);
+   if (thisWords > setWords)
+      count += popcountWords(setPtr + setWords, thisWords - setWords);
+
+   if (set.count > 0 && set.maxNum > maxNum) maxNum = set.maxNum;
+   rankDirValid = false;
 
    return *this;
 }
 
 // --------------------------------------------------------------------------
-// operator*= 
+// operator*=
 // Returns intersection of right and left operands and assigns result to left
-IntSet IntSet::operator*=(const IntSet& set)
+IntSet& IntSet::operator*=(const IntSet& set)
 {
-   for (int i = 0; i <= maxNum; i++) {
-      if (isInSet(i) && !set.isInSet(i))
-         remove(i);
+   INTSET_STATS_OP(STAT_INTERSECTION_ASSIGN);
+   makeOwned();
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+
+   // keep only the bits the parameter also has; words past the end of the
+   // parameter are cleared
+   int words = (thisWords < setWords) ? thisWords : setWords;
+   count = andWords(setPtr, setPtr, set.setPtr, words);
+   for (int i = words; i < thisWords; i++) {
+      setPtr[i] = 0;
    }
 
+   findMaxNum(words - 1);
+   rankDirValid = false;
+
    return *this;
 }
 
 // --------------------------------------------------------------------------
-// operator-= 
-// Difference of two IntSets by subtracting the right operand from 
+// operator-=
+// Difference of two IntSets by subtracting the right operand from
 // the left. Assigns the result to the left operand.
-IntSet IntSet::operator-=(const IntSet& set)
+IntSet& IntSet::operator-=(const IntSet& set)
 {
-   for (int i = 0; i <= maxNum; i++) {
-      if (isInSet(i) && set.isInSet(i))
-         remove(i);
-   }
+   INTSET_STATS_OP(STAT_DIFFERENCE_ASSIGN);
+   makeOwned();
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords < setWords) ? thisWords : setWords;
+
+   // clear every bit the parameter has
+   count = andNotWords(setPtr, setPtr, set.setPtr, words);
+   if (thisWords > words)
+      count += popcountWords(setPtr + words, thisWords - words);
+
+   findMaxNum(thisWords - 1);
+   rankDirValid = false;
 
    return *this;
 }
@@ -282,19 +922,17 @@ IntSet IntSet::operator-=(const IntSet& set)
 // Returns true when two IntSets are the same. Otherwise returns false.
 bool IntSet::operator==(const IntSet& set) const
 {
-   // if the largest integer and number of integers in both sets are the same
-   if (maxNum == set.maxNum && count == set.count) {
+   INTSET_STATS_OP(STAT_EQUALS);
+   // sets of different sizes can not be equal, and all empty sets are equal
+   if (count != set.count) return false;
+   if (count == 0) return true;
 
-      // compare individual numbers in each set
-      // loop over left operand's set
-      for (int i = 0; i <= maxNum; i++) {
-         if (setPtr[i] != set.setPtr[i])
-            // difference was found
-            return false;
-      }
+   // if the largest integer in both sets is the same
+   if (maxNum == set.maxNum) {
 
-      // Both IntSets are equal if no differences were found
-      return true;
+      // compare the words of each set; both are equal if no differences
+      // are found
+      return equalWords(setPtr, set.setPtr, usedWords());
    }
 
    else return false;
@@ -305,36 +943,434 @@ bool IntSet::operator==(const IntSet& set) const
 // Returns true when two IntSets are different. Otherwise returns false.
 bool IntSet::operator!=(const IntSet& set) const
 {
-   // if the largest integer and number of integers in both sets are the same
-   if (maxNum == set.maxNum && count == set.count) {
+   return !(*this == set);
+}
+
+// --------------------------------------------------------------------------
+// memoryUsage
+// Returns the bytes held by the set: the object and the word array it
+// owns (a mapped view owns none)
+long long IntSet::memoryUsage() const
+{
+   long long words = (mapBase == NULL && setPtr != NULL) ? numWords : 0;
+   return sizeof(IntSet) + words * static_cast<long long>(sizeof(uint64_t));
+}
+
+// --------------------------------------------------------------------------
+// intersectionCount
+// Returns the number of integers in both sets
+int IntSet::intersectionCount(const IntSet& set) const
+{
+   INTSET_STATS_OP(STAT_INTERSECTION_COUNT);
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords < setWords) ? thisWords : setWords;
+
+   return static_cast<int>(andCountWords(setPtr, set.setPtr, words));
+}
+
+// --------------------------------------------------------------------------
+// unionCount
+// Returns the number of integers in either set
+int IntSet::unionCount(const IntSet& set) const
+{
+   INTSET_STATS_OP(STAT_UNION_COUNT);
+   return count + set.count - intersectionCount(set);
+}
+
+// --------------------------------------------------------------------------
+// differenceCount
+// Returns the number of integers in this set but not in the parameter
+int IntSet::differenceCount(const IntSet& set) const
+{
+   INTSET_STATS_OP(STAT_DIFFERENCE_COUNT);
+   return count - intersectionCount(set);
+}
+
+// --------------------------------------------------------------------------
+// jaccard
+// Returns the size of the intersection divided by the size of the union,
+// or 1 if both sets are empty
+double IntSet::jaccard(const IntSet& set) const
+{
+   INTSET_STATS_OP(STAT_JACCARD);
+   int common = intersectionCount(set);
+   int either = count + set.count - common;
+
+   return (either == 0) ? 1.0 : static_cast<double>(common) / either;
+}
+
+// --------------------------------------------------------------------------
+// intersects
+// Returns true if the sets have at least one integer in common
+bool IntSet::intersects(const IntSet& set) const
+{
+   INTSET_STATS_OP(STAT_INTERSECTS);
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords < setWords) ? thisWords : setWords;
+
+   return anyAndWords(setPtr, set.setPtr, words);
+}
+
+// --------------------------------------------------------------------------
+// sumChunks
+// Calls work(first, n) for consecutive chunks of words, spread over up to
+// threads threads, and returns the sum of the results
+template<class Work>
+static long long sumChunks(int words, int threads, Work work)
+{
+   int chunks = (words + PARALLEL_CHUNK_WORDS - 1) / PARALLEL_CHUNK_WORDS;
+   if (chunks < 2) return work(0, words);
+
+   vector<long long> results(chunks);
+   WorkerPool::shared().run(chunks, threads, [&](int chunk) {
+      int first = chunk * PARALLEL_CHUNK_WORDS;
+      int n = (words - first < PARALLEL_CHUNK_WORDS) ?
+         words - first : PARALLEL_CHUNK_WORDS;
+      results[chunk] = work(first, n);
+   });
+
+   long long total = 0;
+   for (int chunk = 0; chunk < chunks; chunk++) total += results[chunk];
+   return total;
+}
+
+// --------------------------------------------------------------------------
+// parallelUnion
+// Returns union of two IntSets, computed on up to threads threads
+IntSet IntSet::parallelUnion(const IntSet& set, int threads) const
+{
+   INTSET_STATS_OP(STAT_PARALLEL_UNION);
+   IntSet temp;
+
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords > setWords) ? thisWords : setWords;
+   int common = (thisWords < setWords) ? thisWords : setWords;
+   const IntSet& longer = (thisWords > setWords) ? *this : set;
+
+   // every word is written by a chunk, so the array is not zeroed first
+   // and its pages are first touched by the thread that fills them
+   temp.numWords = words;
+   temp.setPtr = (words > 0) ? newWords(words) : NULL;
+
+   temp.count = static_cast<int>(sumChunks(words, threads,
+      [&](int first, int n) {
+         uint64_t* dst = temp.setPtr + first;
+         int both = (common - first < n) ? common - first : n;
+         if (both < 0) both = 0;
+
+         long long bits = orWords(dst, setPtr + first, set.setPtr + first,
+            both);
+         for (int i = both; i < n; i++) dst[i] = longer.setPtr[first + i];
+         return bits + popcountWords(dst + both, n - both);
+      }));
+
+   temp.maxNum = (maxNum > set.maxNum) ? maxNum : set.maxNum;
+   if (temp.count == 0) temp.maxNum = -1;
+
+   return temp;
+}
+
+// --------------------------------------------------------------------------
+// parallelIntersection
+// Returns intersection of two IntSets, computed on up to threads threads
+IntSet IntSet::parallelIntersection(const IntSet& set, int threads) const
+{
+   INTSET_STATS_OP(STAT_PARALLEL_INTERSECTION);
+   IntSet temp;
+
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int words = (thisWords < setWords) ? thisWords : setWords;
+   temp.numWords = words;
+   temp.setPtr = (words > 0) ? newWords(words) : NULL;
+
+   temp.count = static_cast<int>(sumChunks(words, threads,
+      [&](int first, int n) {
+         return andWords(temp.setPtr + first, setPtr + first,
+            set.setPtr + first, n);
+      }));
+
+   temp.findMaxNum(words - 1);
+
+   return temp;
+}
+
+// --------------------------------------------------------------------------
+// parallelDifference
+// Returns difference of two IntSets, computed on up to threads threads
+IntSet IntSet::parallelDifference(const IntSet& set, int threads) const
+{
+   INTSET_STATS_OP(STAT_PARALLEL_DIFFERENCE);
+   IntSet temp;
+
+   int thisWords = usedWords();
+   int setWords = set.usedWords();
+   int common = (thisWords < setWords) ? thisWords : setWords;
+   temp.numWords = thisWords;
+   temp.setPtr = (thisWords > 0) ? newWords(thisWords) : NULL;
+
+   // words past the end of the parameter are copied unchanged
+   temp.count = static_cast<int>(sumChunks(thisWords, threads,
+      [&](int first, int n) {
+         uint64_t* dst = temp.setPtr + first;
+         int both = (common - first < n) ? common - first : n;
+         if (both < 0) both = 0;
+
+         long long bits = andNotWords(dst, setPtr + first,
+            set.setPtr + first, both);
+         for (int i = both; i < n; i++) dst[i] = setPtr[first + i];
+         return bits + popcountWords(dst + both, n - both);
+      }));
+
+   temp.findMaxNum(thisWords - 1);
+
+   return temp;
+}
+
+// --------------------------------------------------------------------------
+// parallelEquals
+// Returns true when two IntSets are the same, comparing words on up to
+// threads threads. Chunks stop early once any chunk finds a difference
+bool IntSet::parallelEquals(const IntSet& set, int threads) const
+{
+   INTSET_STATS_OP(STAT_PARALLEL_EQUALS);
+   if (count != set.count) return false;
+   if (count == 0) return true;
+   if (maxNum != set.maxNum) return false;
+
+   atomic<bool> differs(false);
+   sumChunks(usedWords(), threads, [&](int first, int n) {
+      if (!differs.load(memory_order_relaxed) &&
+         !equalWords(setPtr + first, set.setPtr + first, n))
+         differs.store(true, memory_order_relaxed);
+      return 0LL;
+   });
+
+   return !differs.load();
+}
+
+// --------------------------------------------------------------------------
+// makeHeader
+// Returns the binary file header describing set
+static BinaryHeader makeHeader(int maxNum, int count, int words)
+{
+   BinaryHeader header;
+   memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+   header.version = BINARY_VERSION;
+   header.maxNum = maxNum;
+   header.count = count;
+   header.words = words;
+   header.reserved = 0;
+   return header;
+}
+
+// --------------------------------------------------------------------------
+// checkHeader
+// Returns true if header is one this version wrote and its word count
+// matches maxNum and the given number of bytes that follow it
+static bool checkHeader(const BinaryHeader& header, long long bytesAfter)
+{
+   if (memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != BINARY_VERSION || header.maxNum < -1 ||
+      header.count < 0)
+      return false;
+
+   long long words = (header.maxNum < 0) ? 0 : header.maxNum / 64 + 1;
+   return header.words == words &&
+      bytesAfter == words * static_cast<long long>(sizeof(uint64_t)) &&
+      (header.count == 0) == (header.maxNum < 0);
+}
+
+// --------------------------------------------------------------------------
+// checkTopWord
+// Returns true if maxNum in a checked header is the highest bit set in the
+// words that follow it (so no bit above maxNum is set). O(1): only the
+// last word is read
+static bool checkTopWord(const BinaryHeader& header, const uint64_t* words)
+{
+   if (header.maxNum < 0) return true;
+
+   uint64_t top = words[header.words - 1];
+   return top != 0 && highestBit64(top) == header.maxNum % 64;
+}
+
+// --------------------------------------------------------------------------
+// checkCount
+// Returns true if count in a checked header is the number of bits set in
+// the words that follow it. Reads every word
+static bool checkCount(const BinaryHeader& header, const uint64_t* words)
+{
+   return popcountWords(words, static_cast<int>(header.words)) ==
+      header.count;
+}
 
-      // compare individual numbers in each set
-      for (int i = 0; i <= maxNum; i++) {
-         if (setPtr[i] != set.setPtr[i])
-            return true;
+// --------------------------------------------------------------------------
+// writeBinary
+// Writes the set to a file in binary format: a 32-byte header followed by
+// the words. Header and words go out in a single writev call (repeated
+// only if the system writes less). Returns false if the file can not be
+// written
+bool IntSet::writeBinary(const char* path) const
+{
+   INTSET_STATS_OP(STAT_WRITE_BINARY);
+#ifndef INTSET_NO_MMAP
+   int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0) return false;
+
+   BinaryHeader header = makeHeader(maxNum, count, usedWords());
+   struct iovec parts[2];
+   parts[0].iov_base = &header;
+   parts[0].iov_len = sizeof(header);
+   parts[1].iov_base = setPtr;
+   parts[1].iov_len = usedWords() * sizeof(uint64_t);
+
+   // keep writing until both parts are out
+   int first = 0;
+   while (first < 2) {
+      ssize_t written = writev(fd, parts + first, 2 - first);
+      if (written < 0) {
+         close(fd);
+         return false;
+      }
+      size_t left = static_cast<size_t>(written);
+      while (first < 2 && left >= parts[first].iov_len) {
+         left -= parts[first].iov_len;
+         first++;
       }
+      if (first < 2) {
+         parts[first].iov_base = static_cast<char*>(parts[first].iov_base) +
+            left;
+         parts[first].iov_len -= left;
+      }
+   }
+
+   return close(fd) == 0;
+#else
+   ofstream file(path, ios::binary);
+   return writeBinary(file) && file.good();
+#endif
+}
+
+// --------------------------------------------------------------------------
+// writeBinary
+// Writes the set to a stream in the same binary format as a file. Returns
+// false if the stream fails
+bool IntSet::writeBinary(ostream& output) const
+{
+   INTSET_STATS_OP(STAT_WRITE_BINARY);
+   BinaryHeader header = makeHeader(maxNum, count, usedWords());
+   output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+   output.write(reinterpret_cast<const char*>(setPtr),
+      usedWords() * sizeof(uint64_t));
+   return output.good();
+}
 
-      // no differences were found
+// --------------------------------------------------------------------------
+// readBinary
+// Replaces the set with one read from a stream in binary format. Returns
+// false (and leaves the set unchanged) if the data is not a valid set
+bool IntSet::readBinary(istream& input)
+{
+   INTSET_STATS_OP(STAT_READ_BINARY);
+   BinaryHeader header;
+   if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)))
+      return false;
+
+   long long words = (header.maxNum < 0) ? 0 : header.maxNum / 64 + 1;
+   if (!checkHeader(header, words * static_cast<long long>(sizeof(uint64_t))))
+      return false;
+
+   IntSet temp;
+   temp.reserveWords(static_cast<int>(words));
+   if (!input.read(reinterpret_cast<char*>(temp.setPtr),
+      words * sizeof(uint64_t)) || !checkTopWord(header, temp.setPtr) ||
+      !checkCount(header, temp.setPtr))
+      return false;
+
+   temp.maxNum = header.maxNum;
+   temp.count = header.count;
+   *this = std::move(temp);
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// mapBinary
+// Replaces the set with a read-only view of a binary file: the file is
+// mapped into memory and its words are used in place, so opening a set of
+// any size costs about the same. The header's word count is checked
+// against the file size and its maxNum against the top word; its count is
+// only checked against the words (one read-only pass over the file) when
+// verify is true. The view is copied into ordinary memory the first time
+// the set changes. Returns false (and leaves the set unchanged) if the
+// file is missing or not a valid set
+bool IntSet::mapBinary(const char* path, bool verify)
+{
+   INTSET_STATS_OP(STAT_MAP_BINARY);
+#ifndef INTSET_NO_MMAP
+   int fd = open(path, O_RDONLY);
+   if (fd < 0) return false;
+
+   struct stat info;
+   if (fstat(fd, &info) != 0 ||
+      info.st_size < static_cast<off_t>(sizeof(BinaryHeader))) {
+      close(fd);
+      return false;
+   }
+
+   size_t length = static_cast<size_t>(info.st_size);
+   void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (base == MAP_FAILED) return false;
+
+   const BinaryHeader* header = static_cast<const BinaryHeader*>(base);
+   const uint64_t* words = reinterpret_cast<const uint64_t*>(
+      static_cast<const char*>(base) + sizeof(BinaryHeader));
+   if (!checkHeader(*header, info.st_size - sizeof(BinaryHeader)) ||
+      !checkTopWord(*header, words) ||
+      (verify && !checkCount(*header, words))) {
+      munmap(base, length);
       return false;
    }
 
-   else return true;
+   releaseWords();
+   delete[] rankDir;
+   rankDir = NULL;
+   rankDirValid = false;
+
+   mapBase = base;
+   mapLength = length;
+   setPtr = reinterpret_cast<uint64_t*>(static_cast<char*>(base) +
+      sizeof(BinaryHeader));
+   numWords = static_cast<int>(header->words);
+   maxNum = header->maxNum;
+   count = header->count;
+   return true;
+#else
+   ifstream file(path, ios::binary);
+   return readBinary(file);
+#endif
+}
+
+// --------------------------------------------------------------------------
+// isView
+// Returns true if the set is a read-only view of a mapped file
+bool IntSet::isView() const
+{
+   return mapBase != NULL;
 }
 
 // --------------------------------------------------------------------------
 // operator<<
 // Returns ostream of the set's integers
-// output is integers in set enclosed by curly brackets. Each integer has a 
+// output is integers in set enclosed by curly brackets. Each integer has a
 // space before it. If set is empty then output is '{}'
 ostream& operator<<(ostream& output, const IntSet& set)
 {
    output << '{';
-
-   for (int i = 0; i <= set.maxNum; i++) {
-      if (set.isInSet(i))
-         output << ' ' << i;
-   }
-
+   set.forEach([&output](int n) { output << ' ' << n; });
    output << '}';
 
    return output;
@@ -343,30 +1379,18 @@ ostream& operator<<(ostream& output, const IntSet& set)
 // --------------------------------------------------------------------------
 // operator>>
 // Returns istream. Reads user input and adds valid integers to set (parameter)
-// ignores negative integers and characters/strings. Stops reading upon 
-// hitting 'return' or 'enter' ('\n'). 
-// Make sure you enter valid integers on a single line (with each integer 
+// ignores negative integers and characters/strings. Stops reading upon
+// hitting 'return' or 'enter' ('\n').
+// Make sure you enter valid integers on a single line (with each integer
 // separated by a space). Hit the 'enter' key when you are done.
 istream& operator>>(istream& input, IntSet& set)
 {
-   int number;
-
-   do {
-      input >> number;
-
-      // ignore negative integers
-      if (number < 0) continue;
-
-      // ignore inputs that are not ints (chars and strings)
-      else if (input.fail()) {
-         input.clear();
-         input.ignore();
-      }
-
-      // add if input is valid integer
-      else set.insert(number);
-
-   } while (input.peek() != '\n'); // keep reading input until new line
+   // like reading ints one at a time, blank lines before the numbers are
+   // skipped
+   string line;
+   input >> ws;
+   getline(input, line);
+   set.insertText(line.data(), line.size());
 
    return input;
-}
\ No newline at end of file
+}
@@ -2,9 +2,23 @@
 
 #ifndef INTSET_H
 #define INTSET_H
+#include "bitkernels.h"
+#include "intsetstats.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
 using namespace std;
 
+// expression types, defined in intsetexpr.h
+class IntSetLeaf;
+template<class Op, class L, class R> class IntSetExpr;
+struct UnionOp;
+struct IntersectionOp;
+struct DifferenceOp;
+
 //---------------------------------------------------------------------------
 // IntSet class:  ADT used to implement a mathematical set of non-negative 
 // integers (includes zero). Each object of class IntSet can keep track of 
@@ -21,14 +35,101 @@ using namespace std;
 //   -- invalid integers (negative ints/chars) will be ignored when using >>
 //   -- press 'enter' or 'return' to end >> (or any other way to enter '\n')
 //   -- in <<, integers are displayed on 1 line between curly brackets
+//   -- members are packed 64 to a word: bit (n % 64) of word (n / 64) is set
+//      when n is in the set, so set algebra runs one word at a time
+//   -- every bit above maxNum is kept zero
+//   -- rank and select use a prefix-count directory (members before each
+//      block of 8 words) built on first use after the set changes, so they
+//      are not safe to call from several threads at once
+//   -- batch operations size the word array once and then set or clear
+//      bits in a tight loop; negative values in a batch are ignored
+//   -- iterators and forEach skip empty words and find the next member of a
+//      word with count-trailing-zeros; an iterator is invalidated by any
+//      change to the set
+//   -- binary format is a 32-byte header (magic "ISET", version, maxNum,
+//      count, number of words) followed by the raw words in native byte
+//      order. mapBinary turns a set into a read-only view of such a file
+//      (mmap); the first change copies the words into ordinary memory.
+//      Files whose header maxNum disagrees with the words are rejected;
+//      readBinary (and mapBinary when asked to verify) also rejects a
+//      count that disagrees
+//   -- parallel operations hand chunks of 16384 words (128 KB per array)
+//      to a shared WorkerPool and add up each chunk's member count; sets
+//      smaller than two chunks are done on the calling thread
+//   -- counting operations (intersectionCount and friends) count the bits
+//      of a & b with vector popcount and derive the others from the member
+//      counts the sets keep; nothing is allocated
+//   -- with INTSET_STATS defined, word array allocations, resizes and
+//      calls to each operation are counted (see intsetstats.h)
+//   -- >> reads one line and hands it to insertText, which scans digits 8
+//      characters at a time and inserts what it finds in batches
+//   -- +, * and - build expressions (see intsetexpr.h) that are computed
+//      in one pass when assigned, so chains make no temporary sets
 //---------------------------------------------------------------------------
 
 class IntSet
 {
    friend ostream& operator<<(ostream&, const IntSet&);
    friend istream& operator>>(istream&, IntSet&);
+   friend class IntSetLeaf;
 
 public:
+   // bidirectional iterator over the members in ascending order.
+   // Dereferencing gives the member by value
+   class const_iterator {
+   public:
+      typedef bidirectional_iterator_tag iterator_category;
+      typedef int value_type;
+      typedef ptrdiff_t difference_type;
+      typedef const int* pointer;
+      typedef int reference;
+
+      const_iterator() : set(NULL), value(-1) {}
+
+      int operator*() const { return value; }
+
+      // incrementing past INT_MAX (the largest possible member) gives end()
+      const_iterator& operator++() {
+         value = (value == INT_MAX) ? -1 : set->nextMember(value + 1);
+         return *this;
+      }
+      const_iterator operator++(int) {
+         const_iterator old = *this;
+         ++*this;
+         return old;
+      }
+
+      // decrementing end() gives the largest member
+      const_iterator& operator--() {
+         value = set->prevMember((value < 0) ? set->maxNum : value - 1);
+         return *this;
+      }
+      const_iterator operator--(int) {
+         const_iterator old = *this;
+         --*this;
+         return old;
+      }
+
+      bool operator==(const const_iterator& other) const {
+         return value == other.value && set == other.set;
+      }
+      bool operator!=(const const_iterator& other) const {
+         return !(*this == other);
+      }
+
+   private:
+      friend class IntSet;
+      const_iterator(const IntSet* s, int v) : set(s), value(v) {}
+
+      // set being walked
+      const IntSet* set;
+
+      // current member, -1 at end()
+      int value;
+   };
+
+   typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
    // default constructor. If parameters are not set, then parameters will be 
    // set to -1
    IntSet(int = -1, int = -1, int = -1, int = -1, int = -1);
@@ -36,44 +137,255 @@ public:
    // copy constructor
    IntSet(const IntSet&);
 
+   // move constructor, leaves the original empty
+   IntSet(IntSet&&) noexcept;
+
+   // set holding every integer in [first, last), e.g. from an array or a
+   // vector. Only takes part in overload resolution for iterator types
+   template<class InputIt,
+      class = typename iterator_traits<InputIt>::iterator_category>
+   IntSet(InputIt first, InputIt last);
+
+   // set holding the result of an expression such as (a + b) * c
+   template<class Op, class L, class R>
+   IntSet(const IntSetExpr<Op, L, R> &);
+
    // destructor
    ~IntSet();
 
    bool insert(int);
    bool remove(int);
 
+   // insert or remove n integers from an array (or the integers in
+   // [first, last)). Return number of integers inserted or removed
+   int insertBatch(const int *, int);
+   int removeBatch(const int *, int);
+   template<class InputIt> int insertBatch(InputIt first, InputIt last);
+   template<class InputIt> int removeBatch(InputIt first, InputIt last);
+
+   // insert every integer from lo through hi (inclusive), filling whole
+   // words at once. Returns number of integers inserted
+   int insertRange(int, int);
+
+   // insert the integers written in text, skipping negative numbers and
+   // anything else, like >>. From length characters, the rest of a stream,
+   // or a file (false if it can not be opened)
+   int insertText(const char *, size_t);
+   int insertText(istream &);
+   bool insertTextFile(const char *);
+
    bool isInSet(int) const;
    bool isEmpty() const;
 
-   // mathematical operators
-   IntSet operator+(const IntSet &) const;
-   IntSet operator*(const IntSet &) const;
-   IntSet operator-(const IntSet &) const;
+   // number of integers in the set
+   int size() const;
+
+   // bytes held by the set (object and word array)
+   long long memoryUsage() const;
+
+   // iterators over the members in ascending (begin/end) or descending
+   // (rbegin/rend) order
+   const_iterator begin() const;
+   const_iterator end() const;
+   const_reverse_iterator rbegin() const;
+   const_reverse_iterator rend() const;
+
+   // calls visit(n) for every member n in ascending order
+   template<class Visitor> void forEach(Visitor visit) const;
+
+   // binary input/output, each returns false on failure. The file version
+   // of writeBinary issues a single write call
+   bool writeBinary(const char *) const;
+   bool writeBinary(ostream &) const;
+   bool readBinary(istream &);
+
+   // replace this set with a read-only view of a file written by
+   // writeBinary, without copying the words. With verify, the header's
+   // count is checked against the words, which reads the whole file
+   bool mapBinary(const char *, bool = false);
 
-   // assignment operator
-   IntSet operator=(const IntSet &);
+   // true if this set is a view of a mapped file
+   bool isView() const;
+
+   // number of integers in the set that are less than n
+   int rank(int) const;
+
+   // k-th smallest integer in the set (k = 0 is the smallest), or -1 if
+   // k is not between 0 and size() - 1
+   int select(int) const;
+
+   // mathematical operators +, * and - are defined in intsetexpr.h and
+   // return expressions
+
+   // assignment operators, the move version leaves the right side empty
+   IntSet& operator=(const IntSet &);
+   IntSet& operator=(IntSet &&) noexcept;
+   template<class Op, class L, class R>
+   IntSet& operator=(const IntSetExpr<Op, L, R> &);
 
    // more mathematical operators
-   IntSet operator+=(const IntSet &);
-   IntSet operator*=(const IntSet &);
-   IntSet operator-=(const IntSet &);
+   IntSet& operator+=(const IntSet &);
+   IntSet& operator*=(const IntSet &);
+   IntSet& operator-=(const IntSet &);
 
    // relational operators
    bool operator==(const IntSet &) const;
    bool operator!=(const IntSet &) const;
 
+   // sizes of the union, intersection and difference with another set,
+   // and their Jaccard similarity (1 for two empty sets), computed without
+   // building the result
+   int unionCount(const IntSet &) const;
+   int intersectionCount(const IntSet &) const;
+   int differenceCount(const IntSet &) const;
+   double jaccard(const IntSet &) const;
+
+   // true if the sets have a member in common, stopping at the first one
+   bool intersects(const IntSet &) const;
+
+   // the same set algebra with the words split into chunks that run on up
+   // to the given number of threads (0 = one per hardware thread)
+   IntSet parallelUnion(const IntSet &, int = 0) const;
+   IntSet parallelIntersection(const IntSet &, int = 0) const;
+   IntSet parallelDifference(const IntSet &, int = 0) const;
+   bool parallelEquals(const IntSet &, int = 0) const;
+
 private:
-   // size of bool array (setPtr)
-   int size;
+   // number of 64-bit words in word array (setPtr). Grows geometrically, so
+   // it can be larger than the words needed to hold maxNum
+   int numWords;
 
-   // pointer to bool array
-   bool *setPtr;
+   // pointer to word array
+   uint64_t *setPtr;
 
    // largest number in set
    int maxNum;
 
    // count of numbers in set
    int count;
+
+   // rank directory: rankDir[b] is the number of members in the words
+   // before block b. Valid only while rankDirValid is true
+   mutable int *rankDir;
+   mutable bool rankDirValid;
+
+   // start and length of the mapped file when this set is a view,
+   // NULL and 0 otherwise. setPtr then points just past the file header
+   void *mapBase;
+   size_t mapLength;
+
+   // number of words needed to hold the integers 0 through n
+   static int wordsFor(int n);
+
+   // number of words that can hold set bits (all words up to maxNum's)
+   int usedWords() const;
+
+   // new uninitialized word array, counted by the statistics
+   static uint64_t *newWords(int);
+
+   // grow word array to exactly the given number of words if it is smaller
+   void reserveWords(int);
+
+   // grow word array so it can hold n, at least doubling it
+   void growFor(int);
+
+   // free the word array (unmap the file for a view)
+   void releaseWords();
+
+   // give a view its own copy of the words so it can be changed
+   void makeOwned();
+
+   // recompute maxNum by scanning down from word index (inclusive)
+   void findMaxNum(int);
+
+   // rebuild rankDir if the set changed since it was last built
+   void buildRankDir() const;
+
+   // smallest member at or above n, or -1 if there is none
+   int nextMember(int) const;
+
+   // largest member at or below n, or -1 if there is none
+   int prevMember(int) const;
+
+   // number of integers batch templates copy to a local array at a time
+   static const int BATCH_SIZE = 1024;
+
+   // single operations on two sets, using the SIMD kernels
+   IntSet unionWith(const IntSet &) const;
+   IntSet intersectionWith(const IntSet &) const;
+   IntSet differenceWith(const IntSet &) const;
+
+   // replace the set with the result of an expression; an operation on
+   // two sets goes to the kernel versions above
+   template<class Expr> void assignExpr(const Expr &);
+   void assignExpr(const IntSetExpr<UnionOp, IntSetLeaf, IntSetLeaf> &);
+   void assignExpr(const IntSetExpr<IntersectionOp, IntSetLeaf,
+      IntSetLeaf> &);
+   void assignExpr(const IntSetExpr<DifferenceOp, IntSetLeaf, IntSetLeaf> &);
 };
 
-#endif
\ No newline at end of file
+// --------------------------------------------------------------------------
+// Constructor
+// Constructor for a set holding every integer in [first, last)
+template<class InputIt, class>
+IntSet::IntSet(InputIt first, InputIt last) : IntSet()
+{
+   insertBatch(first, last);
+}
+
+// --------------------------------------------------------------------------
+// forEach
+// Calls visit(n) for every member n in ascending order, skipping empty
+// words and stepping through each word's set bits from lowest to highest
+template<class Visitor>
+void IntSet::forEach(Visitor visit) const
+{
+   int words = usedWords();
+   for (int w = 0; w < words; w++) {
+      for (uint64_t bits = setPtr[w]; bits != 0; bits &= bits - 1) {
+         visit(w * 64 + lowestBit64(bits));
+      }
+   }
+}
+
+// --------------------------------------------------------------------------
+// insertBatch
+// Inserts every integer in [first, last) by copying them BATCH_SIZE at a
+// time and inserting each group as one batch. Returns number inserted
+template<class InputIt>
+int IntSet::insertBatch(InputIt first, InputIt last)
+{
+   int values[BATCH_SIZE];
+   int inserted = 0;
+
+   while (first != last) {
+      int n = 0;
+      for (; n < BATCH_SIZE && first != last; ++first) values[n++] = *first;
+      inserted += insertBatch(values, n);
+   }
+
+   return inserted;
+}
+
+// --------------------------------------------------------------------------
+// removeBatch
+// Removes every integer in [first, last), BATCH_SIZE at a time. Returns
+// number removed
+template<class InputIt>
+int IntSet::removeBatch(InputIt first, InputIt last)
+{
+   int values[BATCH_SIZE];
+   int removed = 0;
+
+   while (first != last) {
+      int n = 0;
+      for (; n < BATCH_SIZE && first != last; ++first) values[n++] = *first;
+      removed += removeBatch(values, n);
+   }
+
+   return removed;
+}
+
+#include "intsetexpr.h"
+
+#endif
\ No newline at end of file
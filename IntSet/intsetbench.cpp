@@ -0,0 +1,473 @@
+// Created by: Tanvir Tatla
+
+// Benchmark driver for IntSet.
+//   -- times set algebra once for every kernel level (see bitkernels.h) this
+//      CPU supports and prints one line per operation and level:
+//      <operation> <level> <milliseconds per op> <input MB/s> <Gmembers/s>
+//   -- compares 100 intersection sizes computed by building a * b and by
+//      the counting operations
+//   -- compares small-universe unions on IntSet and FixedIntSet<24>
+//   -- counts heap allocations and bytes allocated while inserting 10M
+//      ascending integers and while running compound assignments
+//   -- compares loading 10M random integers with insert and insertBatch
+//   -- times enumerating 1000 members spread over 0..10^8 with forEach,
+//      iterators and reverse iterators
+//   -- compares a fused chained expression with building one temporary set
+//      per operation
+//   -- measures parsing a text file of integers from memory, a mapped
+//      file, a stream, and with ifstream >> int
+//   -- times writing a set to a binary file, mapping it back and copying the
+//      view on its first change
+//   -- compares the bytes held by IntSet and SparseIntSet (before and after
+//      optimize) for sparse members spread over 2^30 integers and for
+//      clustered members in runs
+//   -- times parallel union, intersection and equality of the two random
+//      sets from 1 up to the given number of threads
+//   -- inserts 2^22 random integers per thread from 1 up to the given
+//      number of threads into one ConcurrentIntSet and into one IntSet
+//      guarded by a mutex, and prints million inserts per second
+//   -- when built with -DINTSET_STATS, prints the IntSet statistics as JSON
+// Usage: intsetbench [universe [threads]]
+//   (default universe is 2^26 integers, default threads is the number of
+//   hardware threads)
+
+#include "intset.h"
+#include "concurrentintset.h"
+#include "sparseintset.h"
+#include "fixedintset.h"
+#include "intsetstats.h"
+#include "bitkernels.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// heap allocations and bytes requested through operator new, from any
+// thread
+static atomic<long long> allocations(0);
+static atomic<long long> allocatedBytes(0);
+
+// the counting operators must not be inlined into library code, or GCC
+// sees malloc'd memory passed to operator delete and warns
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void* operator new(size_t bytes)
+{
+   allocations.fetch_add(1, memory_order_relaxed);
+   allocatedBytes.fetch_add(bytes, memory_order_relaxed);
+   void* p = malloc(bytes ? bytes : 1);
+   if (p == NULL) throw bad_alloc();
+   return p;
+}
+
+NOINLINE void* operator new[](size_t bytes)
+{
+   return operator new(bytes);
+}
+
+NOINLINE void operator delete(void* p) noexcept
+{
+   free(p);
+}
+
+NOINLINE void operator delete[](void* p) noexcept
+{
+   free(p);
+}
+
+NOINLINE void operator delete(void* p, size_t) noexcept
+{
+   free(p);
+}
+
+NOINLINE void operator delete[](void* p, size_t) noexcept
+{
+   free(p);
+}
+
+// keeps results alive so the optimizer can not drop the timed work
+static volatile long long sink = 0;
+
+// --------------------------------------------------------------------------
+// fillRandom
+// Inserts each integer below universe into set with probability 1/2
+static void fillRandom(IntSet& set, int universe, unsigned seed)
+{
+   mt19937 rng(seed);
+   for (int i = 0; i < universe; i++) {
+      if (rng() & 1) set.insert(i);
+   }
+}
+
+// --------------------------------------------------------------------------
+// timeOp
+// Runs op repeatedly for at least minSeconds and returns seconds per call
+template<class Op>
+static double timeOp(Op op, double minSeconds = 0.5)
+{
+   typedef chrono::steady_clock Clock;
+   op(); // warm up caches and page in the result
+
+   long long calls = 0;
+   Clock::time_point start = Clock::now();
+   double elapsed = 0;
+   do {
+      op();
+      calls++;
+      elapsed = chrono::duration<double>(Clock::now() - start).count();
+   } while (elapsed < minSeconds);
+
+   return elapsed / calls;
+}
+
+// --------------------------------------------------------------------------
+// report
+// Prints one result line. Two input sets of universe bits are read per call
+static void report(const char* name, KernelIsa isa, double seconds,
+   int universe)
+{
+   double inputBytes = 2.0 * universe / 8;
+   cout << left << setw(14) << name << setw(8) << kernelIsaName(isa)
+      << right << fixed << setprecision(3) << setw(10) << seconds * 1e3
+      << setprecision(0) << setw(10) << inputBytes / seconds / 1e6
+      << setprecision(2) << setw(8) << universe / seconds / 1e9 << endl;
+}
+
+// --------------------------------------------------------------------------
+// timeThreads
+// Runs work(thread) on the given number of threads at once and returns
+// the seconds until all of them finish
+template<class Work>
+static double timeThreads(int threads, Work work)
+{
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+   vector<thread> pool;
+   for (int t = 0; t < threads; t++) pool.emplace_back(work, t);
+   for (thread& worker : pool) worker.join();
+
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// --------------------------------------------------------------------------
+// compareMemory
+// Inserts the same members into an IntSet and a SparseIntSet and prints
+// the bytes each holds, the SparseIntSet also after optimize()
+static void compareMemory(const char* name, const vector<int>& members)
+{
+   IntSet dense;
+   SparseIntSet sparse;
+   dense.insertBatch(members.data(), static_cast<int>(members.size()));
+   for (int n : members) sparse.insert(n);
+   long long inserted = sparse.memoryUsage();
+   sparse.optimize();
+
+   cout << left << setw(24) << name << right << setw(14)
+      << dense.memoryUsage() << setw(14) << inserted << setw(14)
+      << sparse.memoryUsage() << endl;
+   sink += dense.size() + sparse.size();
+}
+
+// --------------------------------------------------------------------------
+// countAllocations
+// Runs op once and prints its time, heap allocations and bytes allocated
+template<class Op>
+static void countAllocations(const char* name, Op op)
+{
+   long long startAllocations = allocations;
+   long long startBytes = allocatedBytes;
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+   op();
+
+   double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   cout << left << setw(24) << name << right << fixed << setprecision(1)
+      << setw(10) << seconds * 1e3 << " ms" << setw(10)
+      << allocations - startAllocations << " allocs" << setw(14)
+      << allocatedBytes - startBytes << " bytes" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+   int universe = (argc > 1) ? atoi(argv[1]) : (1 << 26);
+   int maxThreads = (argc > 2) ? atoi(argv[2]) :
+      static_cast<int>(thread::hardware_concurrency());
+   if (maxThreads < 1) maxThreads = 1;
+
+   IntSet a, b;
+   fillRandom(a, universe, 1);
+   fillRandom(b, universe, 2);
+   IntSet aCopy(a);
+
+   cout << "universe " << universe << ", best level "
+      << kernelIsaName(bestKernelIsa()) << endl;
+   cout << "operation     level     ms/op      MB/s  Gmem/s" << endl;
+
+   const KernelIsa levels[] = { ISA_SCALAR, ISA_SSE2, ISA_AVX2, ISA_AVX512 };
+   for (KernelIsa isa : levels) {
+      if (!setKernelIsa(isa)) continue;
+
+      IntSet c;
+      report("union", isa, timeOp([&] { c = a + b; }), universe);
+      report("intersection", isa, timeOp([&] { c = a * b; }), universe);
+      report("difference", isa, timeOp([&] { c = a - b; }), universe);
+      report("union=", isa, timeOp([&] { c = a; c += b; }), universe);
+      report("equality", isa, timeOp([&] { sink += (a == aCopy); }),
+         universe);
+      sink += c.isEmpty();
+   }
+
+   setKernelIsa(bestKernelIsa());
+
+   cout << endl << "cardinality of a * b" << endl;
+   countAllocations("IntSet(a * b).size()", [&] {
+      for (int i = 0; i < 100; i++) sink += IntSet(a * b).size();
+   });
+   countAllocations("intersectionCount", [&] {
+      for (int i = 0; i < 100; i++) sink += a.intersectionCount(b);
+   });
+   countAllocations("jaccard", [&] {
+      for (int i = 0; i < 100; i++) sink += a.jaccard(b) > 0.5;
+   });
+   countAllocations("intersects", [&] {
+      for (int i = 0; i < 100; i++) sink += a.intersects(b);
+   });
+
+   cout << endl << "10M unions of two 24-hour sets" << endl;
+   const int smallOps = 10000000;
+   countAllocations("IntSet", [&] {
+      IntSet day(9, 12, 17), night(0, 1, 23);
+      int total = 0;
+      for (int i = 0; i < smallOps; i++) {
+         day.insert(i % 24);
+         total += IntSet(day + night).size();
+         day.remove(i % 24);
+      }
+      sink += total;
+   });
+   countAllocations("FixedIntSet<24>", [&] {
+      FixedIntSet<24> day{ 9, 12, 17 }, night{ 0, 1, 23 };
+      int total = 0;
+      for (int i = 0; i < smallOps; i++) {
+         day.insert(i % 24);
+         total += (day + night).size();
+         day.remove(i % 24);
+      }
+      sink += total;
+   });
+
+   cout << endl << "allocation counts" << endl;
+   const int ascending = 10000000;
+   IntSet grown;
+   countAllocations("insert 10M ascending", [&] {
+      for (int i = 0; i < ascending; i++) grown.insert(i);
+   });
+
+   IntSet target;
+   countAllocations("1000 x (c += a) (c -= b)", [&] {
+      for (int i = 0; i < 1000; i++) {
+         target += a;
+         target -= b;
+      }
+   });
+   countAllocations("1000 x c = a + b", [&] {
+      for (int i = 0; i < 1000; i++) target = a + b;
+   });
+   sink += grown.size() + target.size();
+
+   cout << endl << "bulk loading" << endl;
+   vector<int> snapshot(ascending);
+   mt19937 rng(3);
+   for (int i = 0; i < ascending; i++) snapshot[i] = rng() % (4 * ascending);
+
+   IntSet perElement, batched, ranged;
+   countAllocations("insert x 10M random", [&] {
+      for (int i = 0; i < ascending; i++) perElement.insert(snapshot[i]);
+   });
+   countAllocations("insertBatch 10M random", [&] {
+      batched.insertBatch(snapshot.data(), ascending);
+   });
+   countAllocations("insertRange 0..10M-1", [&] {
+      ranged.insertRange(0, ascending - 1);
+   });
+   sink += perElement.size() + batched.size() + ranged.size();
+
+   cout << endl << "enumerating 1000 members, maxNum 10^8" << endl;
+   IntSet spread;
+   for (int i = 0; i < 1000; i++) spread.insert(i * 100000);
+   long long total = 0;
+   countAllocations("forEach", [&] {
+      spread.forEach([&total](int n) { total += n; });
+   });
+   countAllocations("const_iterator", [&] {
+      for (IntSet::const_iterator it = spread.begin(); it != spread.end();
+         ++it)
+         total += *it;
+   });
+   countAllocations("const_reverse_iterator", [&] {
+      for (IntSet::const_reverse_iterator it = spread.rbegin();
+         it != spread.rend(); ++it)
+         total += *it;
+   });
+   sink += total;
+
+   cout << endl << "chained expression e = (a + b) * c - d" << endl;
+   IntSet c, d, chained;
+   fillRandom(c, universe, 4);
+   fillRandom(d, universe, 5);
+   countAllocations("fused expression", [&] { chained = (a + b) * c - d; });
+   countAllocations("one temporary per op", [&] {
+      IntSet sum(a);
+      sum += b;
+      IntSet product(sum);
+      product *= c;
+      IntSet difference(product);
+      difference -= d;
+      chained = std::move(difference);
+   });
+   sink += chained.size();
+
+   cout << endl << "text ingest, 8M newline-separated integers below 10^8"
+      << endl;
+   string text;
+   for (int i = 0; i < 8000000; i++) {
+      text += to_string(rng() % 100000000);
+      text += '\n';
+   }
+   const char* textPath = "intsetbench.txt";
+   {
+      ofstream file(textPath, ios::binary);
+      file << text;
+   }
+   double megabytes = text.size() / 1e6;
+
+   IntSet parsed;
+   double seconds = timeOp([&] {
+      parsed = IntSet();
+      parsed.insertText(text.data(), text.size());
+   }, 0.2);
+   cout << "insertText (memory)   " << fixed << setprecision(0) << setw(8)
+      << megabytes / seconds << " MB/s" << endl;
+   seconds = timeOp([&] {
+      parsed = IntSet();
+      parsed.insertTextFile(textPath);
+   }, 0.2);
+   cout << "insertTextFile (mmap) " << setw(8) << megabytes / seconds
+      << " MB/s" << endl;
+   seconds = timeOp([&] {
+      parsed = IntSet();
+      ifstream file(textPath, ios::binary);
+      parsed.insertText(file);
+   }, 0.2);
+   cout << "insertText (ifstream) " << setw(8) << megabytes / seconds
+      << " MB/s" << endl;
+   seconds = timeOp([&] {
+      parsed = IntSet();
+      ifstream file(textPath, ios::binary);
+      int number;
+      while (file >> number) parsed.insert(number);
+   }, 0.2);
+   cout << "ifstream >> int       " << setw(8) << megabytes / seconds
+      << " MB/s" << endl;
+   sink += parsed.size();
+   remove(textPath);
+
+   cout << endl << "binary files, " << universe << "-bit set" << endl;
+   const char* binaryPath = "intsetbench.bin";
+   countAllocations("writeBinary", [&] { sink += a.writeBinary(binaryPath); });
+   IntSet mapped;
+   countAllocations("mapBinary", [&] { sink += mapped.mapBinary(binaryPath); });
+   countAllocations("size of mapped set", [&] { sink += mapped.size(); });
+   countAllocations("first change to view", [&] {
+      if (!mapped.insert(0)) mapped.remove(0);
+   });
+   remove(binaryPath);
+
+   cout << endl << "memory, bytes" << endl;
+   cout << "members                         IntSet  SparseIntSet"
+      << "     optimized" << endl;
+   vector<int> members;
+   mt19937 spreadRng(6);
+   for (int i = 0; i < 10000; i++) members.push_back(spreadRng() % (1 << 30));
+   compareMemory("10k spread over 2^30", members);
+   members.clear();
+   for (int run = 0; run < 100; run++) {
+      int first = static_cast<int>(spreadRng() % (1 << 30));
+      for (int n = first; n < first + 1000; n++) members.push_back(n);
+   }
+   compareMemory("100 runs of 1000", members);
+   members.clear();
+   for (int n = 0; n < (1 << 20); n++) {
+      if (spreadRng() % 4 != 0) members.push_back(n);
+   }
+   compareMemory("75% of 0..2^20", members);
+
+   cout << endl << "parallel set algebra, ms/op" << endl;
+   cout << "threads     union  intersection  equality" << endl;
+   for (int threads = 1; threads <= maxThreads;
+      threads = (threads < maxThreads && threads * 2 > maxThreads) ?
+      maxThreads : threads * 2) {
+      IntSet c;
+      double united = timeOp([&] { c = a.parallelUnion(b, threads); });
+      double common = timeOp([&] { c = a.parallelIntersection(b, threads); });
+      double equal = timeOp([&] { sink += a.parallelEquals(aCopy, threads); });
+      cout << setw(7) << threads << fixed << setprecision(3) << setw(10)
+         << united * 1e3 << setw(14) << common * 1e3 << setw(10)
+         << equal * 1e3 << endl;
+      sink += c.size();
+   }
+
+   cout << endl << "concurrent inserts, million inserts/s" << endl;
+   cout << "threads  ConcurrentIntSet  IntSet+mutex" << endl;
+   const int perThread = 1 << 22;
+   // 1, 2, 4, ... threads, always ending with maxThreads
+   for (int threads = 1; threads <= maxThreads;
+      threads = (threads < maxThreads && threads * 2 > maxThreads) ?
+      maxThreads : threads * 2) {
+      ConcurrentIntSet shared(universe);
+      double lockFree = timeThreads(threads, [&](int t) {
+         mt19937 local(100 + t);
+         for (int i = 0; i < perThread; i++) shared.insert(local() % universe);
+      });
+
+      IntSet locked;
+      mutex lock;
+      double withMutex = timeThreads(threads, [&](int t) {
+         mt19937 local(100 + t);
+         for (int i = 0; i < perThread; i++) {
+            int n = local() % universe;
+            lock_guard<mutex> guard(lock);
+            locked.insert(n);
+         }
+      });
+
+      double inserts = static_cast<double>(perThread) * threads / 1e6;
+      cout << setw(7) << threads << fixed << setprecision(1) << setw(18)
+         << inserts / lockFree << setw(14) << inserts / withMutex << endl;
+      sink += shared.size() + locked.size();
+   }
+
+   // built with -DINTSET_STATS: dump the counters for the whole run
+   if (intSetStatsEnabled()) {
+      cout << endl << "statistics" << endl;
+      writeIntSetStatsJson(cout);
+      cout << endl;
+   }
+
+   return 0;
+}
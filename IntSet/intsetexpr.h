@@ -0,0 +1,321 @@
+// Created by: Tanvir Tatla
+
+#ifndef INTSETEXPR_H
+#define INTSETEXPR_H
+#include "intset.h"
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// IntSet expressions: +, * and - on IntSets return a small object that
+// records the operation instead of building a new set. Chained operations
+// nest these objects, so (a + b) * c - d is one object holding references
+// to a, b, c and d. Nothing is computed until the expression is assigned
+// to an IntSet (or used to construct one), printed, compared, or asked for
+// size, isEmpty or isInSet; then every word of the result is computed in
+// one pass over the operands' words, with no temporary sets.
+//
+// Implementation and assumptions:
+//   -- word(i) of an expression is word i of its result; leaves return 0
+//      past the end of their set, so operands of different sizes mix
+//   -- an expression holds references to its IntSets and must be used
+//      before they change or go away: keep expressions inside one
+//      statement and do not store them with auto
+//   -- assigning an expression to one of its own operands is safe: each
+//      result word depends only on the operand words with the same index
+//   -- a single operation on two IntSets (c = a + b) uses the SIMD kernels
+//      directly, like the operators did before expressions
+//---------------------------------------------------------------------------
+
+// operations, each combining one word of the left and right operands
+struct UnionOp {
+   static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+   static int words(int left, int right) {
+      return (left > right) ? left : right;
+   }
+};
+
+struct IntersectionOp {
+   static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+   static int words(int left, int right) {
+      return (left < right) ? left : right;
+   }
+};
+
+struct DifferenceOp {
+   static uint64_t apply(uint64_t a, uint64_t b) { return a & ~b; }
+   static int words(int left, int) { return left; }
+};
+
+// --------------------------------------------------------------------------
+// IntSetLeaf
+// An IntSet used as an operand of an expression
+class IntSetLeaf
+{
+public:
+   explicit IntSetLeaf(const IntSet& s)
+      : set(s), bits(s.setPtr), numWords(s.usedWords()) {}
+
+   uint64_t word(int i) const { return (i < numWords) ? bits[i] : 0; }
+   int words() const { return numWords; }
+
+   const IntSet& operand() const { return set; }
+
+private:
+   const IntSet& set;
+   const uint64_t* bits;
+   int numWords;
+};
+
+// --------------------------------------------------------------------------
+// IntSetExpr
+// Operation Op applied to the results of two operands, each an IntSetLeaf
+// or another IntSetExpr
+template<class Op, class L, class R>
+class IntSetExpr
+{
+public:
+   IntSetExpr(const L& l, const R& r)
+      : left(l), right(r), numWords(Op::words(l.words(), r.words())) {}
+
+   uint64_t word(int i) const {
+      return Op::apply(left.word(i), right.word(i));
+   }
+
+   // number of words that can hold members of the result
+   int words() const { return numWords; }
+
+   const L& leftOperand() const { return left; }
+   const R& rightOperand() const { return right; }
+
+   // queries answered without building the result
+   int size() const;
+   bool isEmpty() const;
+   bool isInSet(int) const;
+
+private:
+   L left;
+   R right;
+   int numWords;
+};
+
+// --------------------------------------------------------------------------
+// IntSetOperand
+// Maps an operand type to the expression type that reads it. Only IntSet
+// and IntSetExpr are operands, so the operators below ignore other types
+template<class T> struct IntSetOperand {};
+
+template<> struct IntSetOperand<IntSet> {
+   typedef IntSetLeaf type;
+   static IntSetLeaf make(const IntSet& set) { return IntSetLeaf(set); }
+};
+
+template<class Op, class L, class R>
+struct IntSetOperand<IntSetExpr<Op, L, R>> {
+   typedef IntSetExpr<Op, L, R> type;
+   static const type& make(const type& expr) { return expr; }
+};
+
+// true for IntSetExpr, false for IntSet and everything else
+template<class T> struct IsIntSetExpr { static const bool value = false; };
+
+template<class Op, class L, class R>
+struct IsIntSetExpr<IntSetExpr<Op, L, R>> {
+   static const bool value = true;
+};
+
+// true when A and B are both operands and at least one is an expression
+template<class A, class B> struct IsIntSetExprPair {
+   static const bool value =
+      (IsIntSetExpr<A>::value || is_same<A, IntSet>::value) &&
+      (IsIntSetExpr<B>::value || is_same<B, IntSet>::value) &&
+      (IsIntSetExpr<A>::value || IsIntSetExpr<B>::value);
+};
+
+// number of result words computed before their bits are counted with the
+// popcount kernel, small enough to still be in L1 cache when counted
+const int EXPR_BLOCK_WORDS = 256;
+
+// --------------------------------------------------------------------------
+// size
+// Returns the number of members of the result, computing it a block of
+// words at a time into a local buffer that the popcount kernel counts
+template<class Op, class L, class R>
+int IntSetExpr<Op, L, R>::size() const
+{
+   uint64_t block[EXPR_BLOCK_WORDS];
+   long long total = 0;
+   for (int start = 0; start < numWords; start += EXPR_BLOCK_WORDS) {
+      int n = numWords - start;
+      n = (n < EXPR_BLOCK_WORDS) ? n : EXPR_BLOCK_WORDS;
+      for (int i = 0; i < n; i++) block[i] = word(start + i);
+      total += popcountWords(block, n);
+   }
+   return static_cast<int>(total);
+}
+
+// --------------------------------------------------------------------------
+// isEmpty
+// Returns true if the result has no members, stopping at the first word
+// that has one
+template<class Op, class L, class R>
+bool IntSetExpr<Op, L, R>::isEmpty() const
+{
+   for (int i = 0; i < numWords; i++) {
+      if (word(i) != 0) return false;
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// isInSet
+// Returns true if n is in the result, computing only n's word
+template<class Op, class L, class R>
+bool IntSetExpr<Op, L, R>::isInSet(int n) const
+{
+   if (n < 0 || n / 64 >= numWords) return false;
+   return (word(n / 64) >> (n % 64)) & 1;
+}
+
+// --------------------------------------------------------------------------
+// operator+
+// Returns union of two operands (IntSets or expressions)
+template<class A, class B>
+IntSetExpr<UnionOp, typename IntSetOperand<A>::type,
+   typename IntSetOperand<B>::type> operator+(const A& a, const B& b)
+{
+   return IntSetExpr<UnionOp, typename IntSetOperand<A>::type,
+      typename IntSetOperand<B>::type>(IntSetOperand<A>::make(a),
+      IntSetOperand<B>::make(b));
+}
+
+// --------------------------------------------------------------------------
+// operator*
+// Returns intersection of two operands (IntSets or expressions)
+template<class A, class B>
+IntSetExpr<IntersectionOp, typename IntSetOperand<A>::type,
+   typename IntSetOperand<B>::type> operator*(const A& a, const B& b)
+{
+   return IntSetExpr<IntersectionOp, typename IntSetOperand<A>::type,
+      typename IntSetOperand<B>::type>(IntSetOperand<A>::make(a),
+      IntSetOperand<B>::make(b));
+}
+
+// --------------------------------------------------------------------------
+// operator-
+// Returns difference of two operands (IntSets or expressions)
+template<class A, class B>
+IntSetExpr<DifferenceOp, typename IntSetOperand<A>::type,
+   typename IntSetOperand<B>::type> operator-(const A& a, const B& b)
+{
+   return IntSetExpr<DifferenceOp, typename IntSetOperand<A>::type,
+      typename IntSetOperand<B>::type>(IntSetOperand<A>::make(a),
+      IntSetOperand<B>::make(b));
+}
+
+// --------------------------------------------------------------------------
+// operator==
+// Returns true when two operands, at least one an expression, have the
+// same members. Compares word by word without building either result
+template<class A, class B>
+typename enable_if<IsIntSetExprPair<A, B>::value, bool>::type
+operator==(const A& a, const B& b)
+{
+   typename IntSetOperand<A>::type left = IntSetOperand<A>::make(a);
+   typename IntSetOperand<B>::type right = IntSetOperand<B>::make(b);
+
+   int words = UnionOp::words(left.words(), right.words());
+   for (int i = 0; i < words; i++) {
+      if (left.word(i) != right.word(i)) return false;
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// operator!=
+// Returns true when two operands, at least one an expression, differ
+template<class A, class B>
+typename enable_if<IsIntSetExprPair<A, B>::value, bool>::type
+operator!=(const A& a, const B& b)
+{
+   return !(a == b);
+}
+
+// --------------------------------------------------------------------------
+// operator<<
+// Returns ostream. Displays the result of an expression like an IntSet
+template<class Op, class L, class R>
+ostream& operator<<(ostream& output, const IntSetExpr<Op, L, R>& expr)
+{
+   output << '{';
+   for (int w = 0; w < expr.words(); w++) {
+      for (uint64_t bits = expr.word(w); bits != 0; bits &= bits - 1) {
+         output << ' ' << w * 64 + lowestBit64(bits);
+      }
+   }
+   output << '}';
+
+   return output;
+}
+
+// --------------------------------------------------------------------------
+// Constructor
+// Constructor for the set an expression describes
+template<class Op, class L, class R>
+IntSet::IntSet(const IntSetExpr<Op, L, R>& expr) : IntSet()
+{
+   assignExpr(expr);
+}
+
+// --------------------------------------------------------------------------
+// operator=
+// Replaces the set with the result of an expression
+template<class Op, class L, class R>
+IntSet& IntSet::operator=(const IntSetExpr<Op, L, R>& expr)
+{
+   assignExpr(expr);
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// assignExpr
+// Computes every word of the expression once, storing it and counting its
+// members a block at a time. Writes in place when the word array is big
+// enough (an operand may be this set), otherwise into a new array that
+// replaces the old one
+template<class Expr>
+void IntSet::assignExpr(const Expr& expr)
+{
+   INTSET_STATS_OP(STAT_EXPRESSION);
+   int words = expr.words();
+   int oldWords = usedWords();
+   bool fresh = words > numWords || mapBase != NULL;
+   uint64_t* dst = fresh ? newWords(words) : setPtr;
+
+   // each block is counted right after it is stored, while still cached
+   long long total = 0;
+   for (int start = 0; start < words; start += EXPR_BLOCK_WORDS) {
+      int end = start + EXPR_BLOCK_WORDS;
+      end = (end < words) ? end : words;
+      for (int i = start; i < end; i++) dst[i] = expr.word(i);
+      total += popcountWords(dst + start, end - start);
+   }
+
+   if (fresh) {
+      releaseWords();
+      setPtr = dst;
+      numWords = words;
+   }
+   else {
+      // clear words that held members before but are past the result
+      for (int i = words; i < oldWords; i++) setPtr[i] = 0;
+   }
+
+   count = static_cast<int>(total);
+   findMaxNum(words - 1);
+   rankDirValid = false;
+}
+
+#endif
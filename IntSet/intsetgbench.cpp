@@ -0,0 +1,337 @@
+// Created by: Tanvir Tatla
+
+// Google Benchmark suite for IntSet. Every benchmark takes two arguments:
+//   universe  members are drawn from the integers 0 .. universe - 1
+//   density   members per 100000 integers of the universe, so 1 is
+//             0.001% and 100000 is every integer
+// Universes run from 10^3 to 10^9 and densities from 0.001% to 100%.
+// Benchmarks that need a list of every member (inserts, removes, printing)
+// skip configurations with more than 2^24 members.
+//
+// For machine-readable results run
+//   intsetgbench --benchmark_out=results.json --benchmark_out_format=json
+// (the bench-json CMake target does this).
+
+#include "intset.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <vector>
+using namespace std;
+
+// density of a set holding every integer of its universe
+const int DENSITY_SCALE = 100000;
+
+// largest number of members a benchmark lists one by one
+const long long MAX_LISTED = 1 << 24;
+
+// number of lookups timed per isInSet iteration
+const int PROBES = 4096;
+
+// --------------------------------------------------------------------------
+// memberCount
+// Returns the expected number of members for a universe and density
+static long long memberCount(long long universe, long long density)
+{
+   return universe * density / DENSITY_SCALE;
+}
+
+// --------------------------------------------------------------------------
+// sample
+// Calls visit(n) in ascending order for a random subset of 0 .. universe-1
+// where each integer is picked with probability density / DENSITY_SCALE.
+// Gaps between members are drawn from the geometric distribution, so the
+// cost is proportional to the number of members, not the universe
+template<class Visit>
+static void sample(int universe, int density, unsigned seed, Visit visit)
+{
+   if (density >= DENSITY_SCALE) {
+      for (int i = 0; i < universe; i++) visit(i);
+      return;
+   }
+
+   mt19937_64 rng(seed);
+   uniform_real_distribution<double> uniform(0.0, 1.0);
+   double logMiss = log1p(-static_cast<double>(density) / DENSITY_SCALE);
+
+   long long n = -1;
+   while (true) {
+      n += 1 + static_cast<long long>(log(1.0 - uniform(rng)) / logMiss);
+      if (n >= universe) break;
+      visit(static_cast<int>(n));
+   }
+}
+
+// --------------------------------------------------------------------------
+// makeSet
+// Returns a random set for a universe and density, loaded in batches
+static IntSet makeSet(int universe, int density, unsigned seed)
+{
+   IntSet set;
+   if (density >= DENSITY_SCALE) {
+      set.insertRange(0, universe - 1);
+      return set;
+   }
+
+   vector<int> batch;
+   batch.reserve(1024);
+   sample(universe, density, seed, [&](int n) {
+      batch.push_back(n);
+      if (batch.size() == 1024) {
+         set.insertBatch(batch.data(), static_cast<int>(batch.size()));
+         batch.clear();
+      }
+   });
+   set.insertBatch(batch.data(), static_cast<int>(batch.size()));
+
+   return set;
+}
+
+// --------------------------------------------------------------------------
+// makeList
+// Returns the members makeSet would pick, in ascending order
+static vector<int> makeList(int universe, int density, unsigned seed)
+{
+   vector<int> members;
+   members.reserve(memberCount(universe, density) + 16);
+   sample(universe, density, seed, [&](int n) { members.push_back(n); });
+   return members;
+}
+
+// --------------------------------------------------------------------------
+// operands
+// Returns set 0 or 1 of a pair of random sets for a universe and density.
+// The last pair is kept, since benchmarks run every configuration in turn
+// and sets near 10^9 take seconds to build
+static const IntSet& operands(int universe, int density, int which)
+{
+   static int cachedUniverse = -1;
+   static int cachedDensity = -1;
+   static IntSet sets[2];
+
+   if (universe != cachedUniverse || density != cachedDensity) {
+      sets[0] = IntSet();
+      sets[1] = IntSet();
+      sets[0] = makeSet(universe, density, 1);
+      sets[1] = makeSet(universe, density, 2);
+      cachedUniverse = universe;
+      cachedDensity = density;
+   }
+
+   return sets[which];
+}
+
+// --------------------------------------------------------------------------
+// NullBuffer
+// Stream buffer that throws away everything written to it
+class NullBuffer : public streambuf
+{
+protected:
+   int overflow(int c) override { return c; }
+   streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// --------------------------------------------------------------------------
+// Configurations
+
+static const int UNIVERSES[] = { 1000, 100000, 10000000, 1000000000 };
+static const int DENSITIES[] = { 1, 100, 10000, DENSITY_SCALE };
+
+// every universe and density
+static void allConfigs(benchmark::internal::Benchmark* bench)
+{
+   bench->ArgNames({ "universe", "density" });
+   for (int universe : UNIVERSES) {
+      for (int density : DENSITIES) bench->Args({ universe, density });
+   }
+}
+
+// configurations small enough to list every member
+static void listedConfigs(benchmark::internal::Benchmark* bench)
+{
+   bench->ArgNames({ "universe", "density" });
+   for (int universe : UNIVERSES) {
+      for (int density : DENSITIES) {
+         if (memberCount(universe, density) <= MAX_LISTED)
+            bench->Args({ universe, density });
+      }
+   }
+}
+
+// --------------------------------------------------------------------------
+// insertAll
+// Times inserting members one at a time into an empty set
+static void insertAll(benchmark::State& state, const vector<int>& members)
+{
+   for (auto _ : state) {
+      IntSet set;
+      for (int n : members) set.insert(n);
+      benchmark::DoNotOptimize(set.size());
+   }
+   state.SetItemsProcessed(state.iterations() * members.size());
+}
+
+static void BM_InsertAscending(benchmark::State& state)
+{
+   vector<int> members = makeList(state.range(0), state.range(1), 1);
+   insertAll(state, members);
+}
+BENCHMARK(BM_InsertAscending)->Apply(listedConfigs);
+
+static void BM_InsertDescending(benchmark::State& state)
+{
+   vector<int> members = makeList(state.range(0), state.range(1), 1);
+   reverse(members.begin(), members.end());
+   insertAll(state, members);
+}
+BENCHMARK(BM_InsertDescending)->Apply(listedConfigs);
+
+static void BM_InsertRandom(benchmark::State& state)
+{
+   vector<int> members = makeList(state.range(0), state.range(1), 1);
+   shuffle(members.begin(), members.end(), mt19937(7));
+   insertAll(state, members);
+}
+BENCHMARK(BM_InsertRandom)->Apply(listedConfigs);
+
+// removes every member in random order; the copy of the full set made
+// before each pass is not timed
+static void BM_Remove(benchmark::State& state)
+{
+   vector<int> members = makeList(state.range(0), state.range(1), 1);
+   const IntSet& full = operands(state.range(0), state.range(1), 0);
+   shuffle(members.begin(), members.end(), mt19937(7));
+
+   for (auto _ : state) {
+      state.PauseTiming();
+      IntSet set(full);
+      state.ResumeTiming();
+      for (int n : members) set.remove(n);
+      benchmark::DoNotOptimize(set.isEmpty());
+   }
+   state.SetItemsProcessed(state.iterations() * members.size());
+}
+BENCHMARK(BM_Remove)->Apply(listedConfigs);
+
+// random lookups spread over the whole universe
+static void BM_IsInSet(benchmark::State& state)
+{
+   int universe = state.range(0);
+   const IntSet& set = operands(universe, state.range(1), 0);
+
+   vector<int> probes(PROBES);
+   mt19937 rng(11);
+   for (int& n : probes) n = rng() % universe;
+
+   for (auto _ : state) {
+      int found = 0;
+      for (int n : probes) found += set.isInSet(n);
+      benchmark::DoNotOptimize(found);
+   }
+   state.SetItemsProcessed(state.iterations() * PROBES);
+}
+BENCHMARK(BM_IsInSet)->Apply(allConfigs);
+
+// --------------------------------------------------------------------------
+// Set operators. Bytes processed count both operands' words
+
+static void setOperatorBytes(benchmark::State& state)
+{
+   state.SetBytesProcessed(state.iterations() * 2 * (state.range(0) / 8));
+}
+
+static void BM_Union(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   const IntSet& b = operands(state.range(0), state.range(1), 1);
+   for (auto _ : state) {
+      IntSet c = a + b;
+      benchmark::DoNotOptimize(c.size());
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_Union)->Apply(allConfigs);
+
+static void BM_Intersection(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   const IntSet& b = operands(state.range(0), state.range(1), 1);
+   for (auto _ : state) {
+      IntSet c = a * b;
+      benchmark::DoNotOptimize(c.size());
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_Intersection)->Apply(allConfigs);
+
+static void BM_Difference(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   const IntSet& b = operands(state.range(0), state.range(1), 1);
+   for (auto _ : state) {
+      IntSet c = a - b;
+      benchmark::DoNotOptimize(c.size());
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_Difference)->Apply(allConfigs);
+
+// a chained expression, computed in one pass
+static void BM_Expression(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   const IntSet& b = operands(state.range(0), state.range(1), 1);
+   for (auto _ : state) {
+      IntSet c = (a + b) * a - b;
+      benchmark::DoNotOptimize(c.size());
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_Expression)->Apply(allConfigs);
+
+// compound assignments into a set that keeps its word array
+static void BM_CompoundAssign(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   const IntSet& b = operands(state.range(0), state.range(1), 1);
+   IntSet c;
+   for (auto _ : state) {
+      c = a;
+      c += b;
+      c -= b;
+      c *= a;
+      benchmark::DoNotOptimize(c.size());
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_CompoundAssign)->Apply(allConfigs);
+
+// equal sets, so every word is compared
+static void BM_Equality(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   IntSet copy(a);
+   for (auto _ : state) {
+      benchmark::DoNotOptimize(a == copy);
+   }
+   setOperatorBytes(state);
+}
+BENCHMARK(BM_Equality)->Apply(allConfigs);
+
+// operator<< into a stream that discards its output
+static void BM_Print(benchmark::State& state)
+{
+   const IntSet& a = operands(state.range(0), state.range(1), 0);
+   NullBuffer buffer;
+   ostream output(&buffer);
+   for (auto _ : state) {
+      output << a;
+   }
+   state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_Print)->Apply(listedConfigs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,158 @@
+// Created by: Tanvir Tatla
+
+#include "intsetstats.h"
+#include <atomic>
+
+// counters behind IntSetStats
+static atomic<long long> bytesAllocated(0);
+static atomic<long long> bytesFreed(0);
+static atomic<long long> peakBytes(0);
+static atomic<long long> allocations(0);
+static atomic<long long> resizes(0);
+static atomic<long long> bytesCopied(0);
+static atomic<long long> calls[STAT_COUNT];
+static atomic<long long> nanoseconds[STAT_COUNT];
+
+// --------------------------------------------------------------------------
+// intSetStatsEnabled
+// Returns true if the counters are being kept
+bool intSetStatsEnabled()
+{
+#ifdef INTSET_STATS
+   return true;
+#else
+   return false;
+#endif
+}
+
+// --------------------------------------------------------------------------
+// recordIntSetAlloc
+// Counts a word array of the given size, raising the peak if needed
+void recordIntSetAlloc(long long bytes)
+{
+   allocations.fetch_add(1, memory_order_relaxed);
+   long long live = bytesAllocated.fetch_add(bytes, memory_order_relaxed) +
+      bytes - bytesFreed.load(memory_order_relaxed);
+
+   long long peak = peakBytes.load(memory_order_relaxed);
+   while (live > peak &&
+      !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+   }
+}
+
+// --------------------------------------------------------------------------
+// recordIntSetFree
+// Counts a word array given back
+void recordIntSetFree(long long bytes)
+{
+   bytesFreed.fetch_add(bytes, memory_order_relaxed);
+}
+
+// --------------------------------------------------------------------------
+// recordIntSetResize
+// Counts a word array grown by copying the given bytes into a larger one
+void recordIntSetResize(long long copied)
+{
+   resizes.fetch_add(1, memory_order_relaxed);
+   bytesCopied.fetch_add(copied, memory_order_relaxed);
+}
+
+// --------------------------------------------------------------------------
+// recordIntSetCall
+// Counts one call of an operation that took the given time
+void recordIntSetCall(IntSetStat stat, long long ns)
+{
+   calls[stat].fetch_add(1, memory_order_relaxed);
+   nanoseconds[stat].fetch_add(ns, memory_order_relaxed);
+}
+
+// --------------------------------------------------------------------------
+// intSetStats
+// Returns a copy of every counter
+IntSetStats intSetStats()
+{
+   IntSetStats stats;
+   stats.bytesAllocated = bytesAllocated.load(memory_order_relaxed);
+   stats.bytesFreed = bytesFreed.load(memory_order_relaxed);
+   stats.bytesLive = stats.bytesAllocated - stats.bytesFreed;
+   stats.peakBytes = peakBytes.load(memory_order_relaxed);
+   stats.allocations = allocations.load(memory_order_relaxed);
+   stats.resizes = resizes.load(memory_order_relaxed);
+   stats.bytesCopied = bytesCopied.load(memory_order_relaxed);
+
+   for (int i = 0; i < STAT_COUNT; i++) {
+      stats.calls[i] = calls[i].load(memory_order_relaxed);
+      stats.nanoseconds[i] = nanoseconds[i].load(memory_order_relaxed);
+   }
+
+   return stats;
+}
+
+// --------------------------------------------------------------------------
+// resetIntSetStats
+// Sets every counter to zero. Bytes still held are kept as live (and as
+// the peak), so later frees do not drive the live count negative
+void resetIntSetStats()
+{
+   long long live = bytesAllocated.load(memory_order_relaxed) -
+      bytesFreed.load(memory_order_relaxed);
+
+   bytesAllocated.store(live, memory_order_relaxed);
+   bytesFreed.store(0, memory_order_relaxed);
+   peakBytes.store(live, memory_order_relaxed);
+   allocations.store(0, memory_order_relaxed);
+   resizes.store(0, memory_order_relaxed);
+   bytesCopied.store(0, memory_order_relaxed);
+
+   for (int i = 0; i < STAT_COUNT; i++) {
+      calls[i].store(0, memory_order_relaxed);
+      nanoseconds[i].store(0, memory_order_relaxed);
+   }
+}
+
+// --------------------------------------------------------------------------
+// intSetStatName
+// Returns the JSON name of an operation
+const char* intSetStatName(IntSetStat stat)
+{
+   static const char* const NAMES[STAT_COUNT] = {
+      "insert", "remove", "insert_batch", "remove_batch", "insert_range",
+      "insert_text", "copy", "assign", "union", "intersection", "difference",
+      "expression", "union_assign", "intersection_assign",
+      "difference_assign", "equals", "intersection_count", "union_count",
+      "difference_count", "jaccard", "intersects", "parallel_union",
+      "parallel_intersection", "parallel_difference", "parallel_equals",
+      "rank", "select", "write_binary", "read_binary", "map_binary"
+   };
+   return (stat >= 0 && stat < STAT_COUNT) ? NAMES[stat] : "unknown";
+}
+
+// --------------------------------------------------------------------------
+// writeIntSetStatsJson
+// Writes the counters as one JSON object: memory totals, then calls and
+// nanoseconds for every operation that was called
+void writeIntSetStatsJson(ostream& output)
+{
+   IntSetStats stats = intSetStats();
+
+   output << "{\"enabled\": " << (intSetStatsEnabled() ? "true" : "false")
+      << ", \"memory\": {\"bytes_allocated\": " << stats.bytesAllocated
+      << ", \"bytes_freed\": " << stats.bytesFreed
+      << ", \"bytes_live\": " << stats.bytesLive
+      << ", \"peak_bytes\": " << stats.peakBytes
+      << ", \"allocations\": " << stats.allocations
+      << ", \"resizes\": " << stats.resizes
+      << ", \"bytes_copied_on_resize\": " << stats.bytesCopied
+      << "}, \"operations\": {";
+
+   const char* separator = "";
+   for (int i = 0; i < STAT_COUNT; i++) {
+      if (stats.calls[i] == 0) continue;
+      output << separator << '"' << intSetStatName(IntSetStat(i))
+         << "\": {\"calls\": " << stats.calls[i] << ", \"nanoseconds\": "
+         << stats.nanoseconds[i] << '}';
+      separator = ", ";
+   }
+
+   output << "}}";
+}
@@ -0,0 +1,115 @@
+// Created by: Tanvir Tatla
+
+#ifndef INTSETSTATS_H
+#define INTSETSTATS_H
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// IntSet statistics: process-wide counters of the memory IntSets allocate
+// for their words and of the calls to each set operation, dumpable as
+// JSON. Compiled in only when INTSET_STATS is defined:
+//   -- build every file that includes intset.h with -DINTSET_STATS (the
+//      macros are also used in inline code, so all files must agree)
+//   -- without INTSET_STATS every INTSET_STATS_ macro expands to nothing
+//      and the counters stay zero; writeIntSetStatsJson then reports
+//      "enabled": false
+//
+// Implementation and assumptions:
+//   -- counters are relaxed atomics, so sets used on several threads are
+//      counted, but a snapshot taken while they run is not exact
+//   -- a resize is a word array grown to a larger one with members copied
+//      over; the first allocation of an empty set is not a resize
+//   -- mapped views (mapBinary) are not allocations
+//   -- an operation's time runs from entry to return and includes any
+//      operation it calls, which is counted too
+//---------------------------------------------------------------------------
+
+// operations with call counts and times, one per public operation
+enum IntSetStat {
+   STAT_INSERT, STAT_REMOVE, STAT_INSERT_BATCH, STAT_REMOVE_BATCH,
+   STAT_INSERT_RANGE, STAT_INSERT_TEXT, STAT_COPY, STAT_ASSIGN,
+   STAT_UNION, STAT_INTERSECTION, STAT_DIFFERENCE, STAT_EXPRESSION,
+   STAT_UNION_ASSIGN, STAT_INTERSECTION_ASSIGN, STAT_DIFFERENCE_ASSIGN,
+   STAT_EQUALS, STAT_INTERSECTION_COUNT, STAT_UNION_COUNT,
+   STAT_DIFFERENCE_COUNT, STAT_JACCARD, STAT_INTERSECTS,
+   STAT_PARALLEL_UNION, STAT_PARALLEL_INTERSECTION, STAT_PARALLEL_DIFFERENCE,
+   STAT_PARALLEL_EQUALS, STAT_RANK, STAT_SELECT, STAT_WRITE_BINARY,
+   STAT_READ_BINARY, STAT_MAP_BINARY, STAT_COUNT
+};
+
+// snapshot of all counters
+struct IntSetStats {
+   // word arrays: bytes allocated and freed, bytes held now and at most
+   long long bytesAllocated;
+   long long bytesFreed;
+   long long bytesLive;
+   long long peakBytes;
+   long long allocations;
+
+   // arrays grown by copying into a larger one, and bytes copied doing so
+   long long resizes;
+   long long bytesCopied;
+
+   // calls and total nanoseconds per operation
+   long long calls[STAT_COUNT];
+   long long nanoseconds[STAT_COUNT];
+};
+
+// true if this build was compiled with INTSET_STATS
+bool intSetStatsEnabled();
+
+// current counters
+IntSetStats intSetStats();
+
+// set every counter to zero (peak becomes the bytes held now)
+void resetIntSetStats();
+
+// write the counters as one JSON object
+void writeIntSetStatsJson(ostream &);
+
+// JSON name of an operation, e.g. "insert_batch"
+const char* intSetStatName(IntSetStat);
+
+// recording functions, called through the macros below
+void recordIntSetAlloc(long long bytes);
+void recordIntSetFree(long long bytes);
+void recordIntSetResize(long long bytesCopied);
+void recordIntSetCall(IntSetStat, long long nanoseconds);
+
+// --------------------------------------------------------------------------
+// IntSetStatTimer
+// Counts one call of an operation and the time until it goes out of scope
+class IntSetStatTimer
+{
+public:
+   explicit IntSetStatTimer(IntSetStat s)
+      : stat(s), start(chrono::steady_clock::now()) {}
+
+   ~IntSetStatTimer() {
+      recordIntSetCall(stat, chrono::duration_cast<chrono::nanoseconds>(
+         chrono::steady_clock::now() - start).count());
+   }
+
+   IntSetStatTimer(const IntSetStatTimer &) = delete;
+   IntSetStatTimer& operator=(const IntSetStatTimer &) = delete;
+
+private:
+   IntSetStat stat;
+   chrono::steady_clock::time_point start;
+};
+
+#ifdef INTSET_STATS
+#define INTSET_STATS_ALLOC(bytes) recordIntSetAlloc(bytes)
+#define INTSET_STATS_FREE(bytes) recordIntSetFree(bytes)
+#define INTSET_STATS_RESIZE(bytesCopied) recordIntSetResize(bytesCopied)
+#define INTSET_STATS_OP(stat) IntSetStatTimer intSetStatTimer(stat)
+#else
+#define INTSET_STATS_ALLOC(bytes) ((void)0)
+#define INTSET_STATS_FREE(bytes) ((void)0)
+#define INTSET_STATS_RESIZE(bytesCopied) ((void)0)
+#define INTSET_STATS_OP(stat) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,332 @@
+// Created by: Tanvir Tatla
+
+// Tests for the IntSet statistics counters (intsetstats.h).
+//   -- built against a copy of the library compiled with INTSET_STATS, so
+//      the counters are live whatever the INTSET_STATS option says
+//   -- each test resets the counters, runs a known sequence of operations
+//      and checks the totals exactly
+//   -- main runs every test and prints "Done!"; ctest runs it as
+//      intsetstatstest
+
+// the project builds as Release by default, which would turn asserts off
+#undef NDEBUG
+
+#include "intset.h"
+#include <cassert>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+static bool parseValue(const string& text, size_t& at);
+
+// --------------------------------------------------------------------------
+// skipSpace
+// Moves at past any JSON whitespace
+static void skipSpace(const string& text, size_t& at)
+{
+   while (at < text.size() && isspace(static_cast<unsigned char>(text[at])))
+      at++;
+}
+
+// --------------------------------------------------------------------------
+// parseString
+// Reads a JSON string (the names written contain no escapes). Returns
+// false if text at at is not one
+static bool parseString(const string& text, size_t& at)
+{
+   if (at >= text.size() || text[at] != '"') return false;
+   for (at++; at < text.size() && text[at] != '"'; at++) {
+      if (text[at] == '\\' || static_cast<unsigned char>(text[at]) < ' ')
+         return false;
+   }
+   if (at >= text.size()) return false;
+   at++;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// parseNumber
+// Reads a JSON integer. Returns false if text at at is not one
+static bool parseNumber(const string& text, size_t& at)
+{
+   size_t start = at;
+   if (at < text.size() && text[at] == '-') at++;
+   if (at >= text.size() || !isdigit(static_cast<unsigned char>(text[at])))
+      return false;
+   if (text[at] == '0' && at + 1 < text.size() &&
+      isdigit(static_cast<unsigned char>(text[at + 1])))
+      return false;
+   while (at < text.size() && isdigit(static_cast<unsigned char>(text[at])))
+      at++;
+   return at > start;
+}
+
+// --------------------------------------------------------------------------
+// parseObject
+// Reads a JSON object of "name": value pairs. Returns false if text at at
+// is not one
+static bool parseObject(const string& text, size_t& at)
+{
+   if (at >= text.size() || text[at] != '{') return false;
+   at++;
+   skipSpace(text, at);
+   if (at < text.size() && text[at] == '}') {
+      at++;
+      return true;
+   }
+
+   while (true) {
+      skipSpace(text, at);
+      if (!parseString(text, at)) return false;
+      skipSpace(text, at);
+      if (at >= text.size() || text[at] != ':') return false;
+      at++;
+      if (!parseValue(text, at)) return false;
+      skipSpace(text, at);
+      if (at >= text.size()) return false;
+      if (text[at] == '}') {
+         at++;
+         return true;
+      }
+      if (text[at] != ',') return false;
+      at++;
+   }
+}
+
+// --------------------------------------------------------------------------
+// parseValue
+// Reads one JSON value of the kinds writeIntSetStatsJson writes: object,
+// string, integer, true or false. Returns false if text at at is not one
+static bool parseValue(const string& text, size_t& at)
+{
+   skipSpace(text, at);
+   if (at >= text.size()) return false;
+
+   switch (text[at]) {
+   case '{':
+      return parseObject(text, at);
+   case '"':
+      return parseString(text, at);
+   case 't':
+      at += 4;
+      return text.compare(at - 4, 4, "true") == 0;
+   case 'f':
+      at += 5;
+      return text.compare(at - 5, 5, "false") == 0;
+   default:
+      return parseNumber(text, at);
+   }
+}
+
+// --------------------------------------------------------------------------
+// isJson
+// Returns true if text is exactly one well formed JSON value
+static bool isJson(const string& text)
+{
+   size_t at = 0;
+   if (!parseValue(text, at)) return false;
+   skipSpace(text, at);
+   return at == text.size();
+}
+
+// --------------------------------------------------------------------------
+// statsJson
+// Returns what writeIntSetStatsJson writes now
+static string statsJson()
+{
+   ostringstream output;
+   writeIntSetStatsJson(output);
+   return output.str();
+}
+
+// --------------------------------------------------------------------------
+// testMemory
+// Growing one set word by word: each growth allocates a larger array
+// (at least double), copies the old words into it and frees them
+static void testMemory()
+{
+   resetIntSetStats();
+   IntSetStats stats = intSetStats();
+   assert(stats.bytesLive == 0 && stats.allocations == 0);
+
+   {
+      IntSet a(10);           // 1 word
+      assert(a.insert(100));  // 2 words, 1 copied
+      assert(a.insert(200));  // 4 words, 2 copied
+      assert(a.insert(50));   // fits
+      assert(!a.insert(50));  // duplicate, still a call
+
+      stats = intSetStats();
+      assert(stats.allocations == 3);
+      assert(stats.resizes == 2);
+      assert(stats.bytesCopied == 3 * 8);
+      assert(stats.bytesAllocated == (1 + 2 + 4) * 8);
+      assert(stats.bytesFreed == (1 + 2) * 8);
+      assert(stats.bytesLive == 4 * 8);
+      assert(stats.peakBytes == (2 + 4) * 8);
+      assert(stats.calls[STAT_INSERT] == 4);
+      assert(stats.calls[STAT_REMOVE] == 0);
+
+      // the first allocation of an empty set is not a resize
+      IntSet b;
+      assert(b.insert(70));
+      stats = intSetStats();
+      assert(stats.allocations == 4 && stats.resizes == 2);
+      assert(stats.calls[STAT_INSERT] == 5);
+   }
+
+   stats = intSetStats();
+   assert(stats.bytesLive == 0);
+   assert(stats.bytesFreed == stats.bytesAllocated);
+
+   // a reset keeps what is still held as live
+   IntSet c(300);
+   resetIntSetStats();
+   stats = intSetStats();
+   assert(stats.allocations == 0 && stats.bytesLive == 5 * 8);
+   assert(stats.peakBytes == 5 * 8);
+}
+
+// --------------------------------------------------------------------------
+// testCalls
+// Calls every public operation once and checks that each has its own
+// count; operations built on another also count that one
+static void testCalls()
+{
+   IntSet a(1, 2, 3, 100), b(2, 3, 4);
+   int values[] = { 5, 6, 7 };
+   resetIntSetStats();
+
+   IntSet copy(a);
+   copy = b;
+   a.insertBatch(values, 3);
+   a.removeBatch(values, 2);
+   a.insertRange(20, 30);
+   a.insertText("40 41 42", 8);
+   a.remove(42);
+   IntSet both = a + b;
+   IntSet common = a * b;
+   IntSet onlyA = a - b;
+   copy += a;
+   copy *= a;
+   copy -= b;
+   assert(!(a == b));
+   assert(a.intersectionCount(b) == common.size());
+   assert(a.unionCount(b) == both.size());
+   assert(a.differenceCount(b) == onlyA.size());
+   assert(a.jaccard(b) > 0);
+   assert(a.intersects(b));
+   assert(a.parallelUnion(b, 2) == both);
+   assert(a.parallelIntersection(b, 2) == common);
+   assert(a.parallelDifference(b, 2) == onlyA);
+   assert(a.parallelEquals(a, 2));
+   assert(a.rank(4) == 3);
+   assert(a.select(0) == 1);
+   copy = a + b * both;
+
+   stringstream buffer;
+   assert(a.writeBinary(buffer));
+   IntSet read;
+   assert(read.readBinary(buffer) && read == a);
+   const char* path = "intsetstatstest.bin";
+   assert(a.writeBinary(path));
+   IntSet mapped;
+   assert(mapped.mapBinary(path));
+   remove(path);
+
+   IntSetStats stats = intSetStats();
+   assert(stats.calls[STAT_COPY] >= 1);
+   assert(stats.calls[STAT_ASSIGN] >= 1);
+   assert(stats.calls[STAT_INSERT_BATCH] == 2);  // one from insertText
+   assert(stats.calls[STAT_REMOVE_BATCH] == 1);
+   assert(stats.calls[STAT_INSERT_RANGE] == 1);
+   assert(stats.calls[STAT_INSERT_TEXT] == 1);
+   assert(stats.calls[STAT_REMOVE] == 1);
+   assert(stats.calls[STAT_UNION] == 1);
+   assert(stats.calls[STAT_INTERSECTION] == 1);
+   assert(stats.calls[STAT_DIFFERENCE] == 1);
+   assert(stats.calls[STAT_UNION_ASSIGN] == 1);
+   assert(stats.calls[STAT_INTERSECTION_ASSIGN] == 1);
+   assert(stats.calls[STAT_DIFFERENCE_ASSIGN] == 2);  // one from a - b
+   assert(stats.calls[STAT_EXPRESSION] == 1);
+   assert(stats.calls[STAT_EQUALS] == 5);
+
+   // unionCount, differenceCount and jaccard are built on
+   // intersectionCount
+   assert(stats.calls[STAT_INTERSECTION_COUNT] == 4);
+   assert(stats.calls[STAT_UNION_COUNT] == 1);
+   assert(stats.calls[STAT_DIFFERENCE_COUNT] == 1);
+   assert(stats.calls[STAT_JACCARD] == 1);
+   assert(stats.calls[STAT_INTERSECTS] == 1);
+
+   assert(stats.calls[STAT_PARALLEL_UNION] == 1);
+   assert(stats.calls[STAT_PARALLEL_INTERSECTION] == 1);
+   assert(stats.calls[STAT_PARALLEL_DIFFERENCE] == 1);
+   assert(stats.calls[STAT_PARALLEL_EQUALS] == 1);
+   assert(stats.calls[STAT_RANK] == 1);
+   assert(stats.calls[STAT_SELECT] == 1);
+   assert(stats.calls[STAT_WRITE_BINARY] >= 2);
+   assert(stats.calls[STAT_READ_BINARY] == 1);
+   assert(stats.calls[STAT_MAP_BINARY] == 1);
+
+   // every operation has a distinct name
+   for (int i = 0; i < STAT_COUNT; i++) {
+      string name = intSetStatName(IntSetStat(i));
+      assert(name != "unknown");
+      for (int j = 0; j < i; j++)
+         assert(name != intSetStatName(IntSetStat(j)));
+   }
+   assert(string(intSetStatName(STAT_COUNT)) == "unknown");
+}
+
+// --------------------------------------------------------------------------
+// testJson
+// The dump is one well formed object holding the counters just taken
+static void testJson()
+{
+   assert(isJson("{}"));
+   assert(isJson("{\"a\": {\"b\": 1, \"c\": true}, \"d\": -20}"));
+   assert(!isJson("{\"a\": 1,}"));
+   assert(!isJson("{\"a\": 1} {}"));
+   assert(!isJson("{\"a\" 1}"));
+   assert(!isJson("{\"a\": {\"b\": 1}"));
+   assert(!isJson("{\"a\": 01}"));
+
+   // nothing called yet: an empty operations object
+   resetIntSetStats();
+   string json = statsJson();
+   assert(isJson(json));
+   assert(json.compare(0, 16, "{\"enabled\": true") == 0);
+   assert(json.find("\"operations\": {}") != string::npos);
+
+   {
+      IntSet a(1), b(2);
+      a.insert(64);
+      IntSet both = a + b;
+      assert(a.parallelEquals(a, 2));
+   }
+
+   json = statsJson();
+   assert(isJson(json));
+   assert(json.find("\"allocations\": 4") != string::npos);
+   assert(json.find("\"resizes\": 1") != string::npos);
+   assert(json.find("\"bytes_live\": 0") != string::npos);
+   assert(json.find("\"insert\": {\"calls\": 1, ") != string::npos);
+   assert(json.find("\"union\": {\"calls\": 1, ") != string::npos);
+   assert(json.find("\"parallel_equals\": {\"calls\": 1, ") !=
+      string::npos);
+   assert(json.find("\"remove\"") == string::npos);
+}
+
+int main()
+{
+   assert(intSetStatsEnabled());
+   testMemory();
+   testCalls();
+   testJson();
+   cout << "Done!" << endl;
+   return 0;
+}
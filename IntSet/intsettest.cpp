@@ -0,0 +1,1330 @@
+// Created by: Tanvir Tatla
+
+// Tests for IntSet and the classes built on it.
+//   -- each test function checks one feature, mostly by doing the same
+//      thing to a std::set and comparing, and stops at the first failed
+//      assert
+//   -- main runs every test and prints "Done!"; ctest runs it as intsettest
+
+// the project builds as Release by default, which would turn asserts off
+#undef NDEBUG
+
+#include "intset.h"
+#include "sparseintset.h"
+#include "fixedintset.h"
+#include "concurrentintset.h"
+#include "workerpool.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// --------------------------------------------------------------------------
+// toString
+// Returns what operator<< prints for an IntSet (or any set type with one)
+template<class Set>
+static string toString(const Set& actual)
+{
+   ostringstream output;
+   output << actual;
+   return output.str();
+}
+
+// --------------------------------------------------------------------------
+// toString
+// Returns what operator<< would print for a set holding the members of s
+static string toString(const set<int>& s)
+{
+   ostringstream output;
+   output << '{';
+   for (int n : s) output << ' ' << n;
+   output << '}';
+   return output.str();
+}
+
+// --------------------------------------------------------------------------
+// checkSame
+// Asserts that an IntSet has exactly the members of s
+static void checkSame(const IntSet& actual, const set<int>& s)
+{
+   assert(actual.size() == static_cast<int>(s.size()));
+   assert(actual.isEmpty() == s.empty());
+   assert(toString(actual) == toString(s));
+   for (int n : s) {
+      assert(actual.isInSet(n));
+      assert(n == INT_MAX || !actual.isInSet(n + 1) || s.count(n + 1) == 1);
+   }
+}
+
+// --------------------------------------------------------------------------
+// randomSet
+// Fills actual and s with the same count random integers below universe
+static void randomSet(IntSet& actual, set<int>& s, int count, int universe,
+   unsigned seed)
+{
+   mt19937 rng(seed);
+   for (int i = 0; i < count; i++) {
+      int n = static_cast<int>(rng() % universe);
+      assert(actual.insert(n) == s.insert(n).second);
+   }
+}
+
+// --------------------------------------------------------------------------
+// testWordPacking
+// Members on both sides of word boundaries, maxNum, and set algebra on
+// sets of different lengths
+static void testWordPacking()
+{
+   cout << "Starting testWordPacking" << endl;
+
+   IntSet a(63, 64, 0, -5), empty;
+   set<int> s = { 0, 63, 64 };
+   checkSame(a, s);
+   checkSame(empty, set<int>());
+   assert(toString(empty) == "{}");
+   assert(!a.isInSet(-5) && !a.isInSet(65) && !a.isInSet(1000000));
+
+   // every position of a word, and the words around it
+   for (int n = 120; n <= 200; n++) {
+      assert(a.insert(n) && !a.insert(n));
+      s.insert(n);
+   }
+   checkSame(a, s);
+   for (int n = 127; n <= 192; n += 2) {
+      assert(a.remove(n) && !a.remove(n));
+      s.erase(n);
+   }
+   checkSame(a, s);
+
+   // removing the largest member finds the new one a word lower
+   for (int n = 200; n >= 128; n--) {
+      a.remove(n);
+      s.erase(n);
+   }
+   checkSame(a, s);
+   a.insert(1000);
+   a.remove(1000);
+   checkSame(a, s);
+
+   // set algebra against std::set, long and short operands both ways
+   IntSet big, small;
+   set<int> bigSet, smallSet;
+   randomSet(big, bigSet, 3000, 10000, 1);
+   randomSet(small, smallSet, 200, 700, 2);
+
+   for (int order = 0; order < 2; order++) {
+      const IntSet& x = (order == 0) ? big : small;
+      const IntSet& y = (order == 0) ? small : big;
+      const set<int>& xs = (order == 0) ? bigSet : smallSet;
+      const set<int>& ys = (order == 0) ? smallSet : bigSet;
+
+      set<int> expected;
+      set_union(xs.begin(), xs.end(), ys.begin(), ys.end(),
+         inserter(expected, expected.end()));
+      IntSet result = x + y;
+      checkSame(result, expected);
+      IntSet assigned(x);
+      assigned += y;
+      checkSame(assigned, expected);
+
+      expected.clear();
+      set_intersection(xs.begin(), xs.end(), ys.begin(), ys.end(),
+         inserter(expected, expected.end()));
+      result = x * y;
+      checkSame(result, expected);
+      assigned = x;
+      assigned *= y;
+      checkSame(assigned, expected);
+
+      expected.clear();
+      set_difference(xs.begin(), xs.end(), ys.begin(), ys.end(),
+         inserter(expected, expected.end()));
+      result = x - y;
+      checkSame(result, expected);
+      assigned = x;
+      assigned -= y;
+      checkSame(assigned, expected);
+   }
+
+   // equality ignores how many words each set has allocated
+   IntSet shrunk(big);
+   shrunk.insert(50000);
+   shrunk.remove(50000);
+   assert(shrunk == big && !(shrunk != big));
+   shrunk.remove(*bigSet.begin());
+   assert(shrunk != big);
+   assert(empty == IntSet() && empty != a);
+
+   cout << "Ending testWordPacking" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testKernels
+// Every kernel at every level the CPU supports gives the same results as a
+// plain loop, for lengths that leave a partial vector at the end, and set
+// algebra built on them still matches std::set
+static void testKernels()
+{
+   cout << "Starting testKernels" << endl;
+
+   const int maxWords = 77;
+   uint64_t a[maxWords], b[maxWords], dst[maxWords];
+   mt19937_64 rng(3);
+   for (int i = 0; i < maxWords; i++) {
+      a[i] = rng();
+      b[i] = (i % 5 == 0) ? 0 : rng() & rng();
+   }
+
+   IntSet x, y;
+   set<int> xs, ys, expected;
+   randomSet(x, xs, 5000, 40000, 4);
+   randomSet(y, ys, 5000, 30000, 5);
+   set_intersection(xs.begin(), xs.end(), ys.begin(), ys.end(),
+      inserter(expected, expected.end()));
+
+   KernelIsa best = bestKernelIsa();
+   assert(activeKernelIsa() == best);
+   for (int level = ISA_SCALAR; level <= ISA_AVX512; level++) {
+      KernelIsa isa = static_cast<KernelIsa>(level);
+      if (!setKernelIsa(isa)) {
+         assert(isa > best && activeKernelIsa() != isa);
+         continue;
+      }
+      assert(activeKernelIsa() == isa && kernelIsaName(isa) != NULL);
+
+      for (int n = 0; n <= maxWords; n++) {
+         long long orBits = 0, andBits = 0, andNotBits = 0, bits = 0;
+         bool any = false;
+         for (int i = 0; i < n; i++) {
+            orBits += popcount64(a[i] | b[i]);
+            andBits += popcount64(a[i] & b[i]);
+            andNotBits += popcount64(a[i] & ~b[i]);
+            bits += popcount64(a[i]);
+            any = any || (a[i] & b[i]) != 0;
+         }
+
+         assert(orWords(dst, a, b, n) == orBits);
+         for (int i = 0; i < n; i++) assert(dst[i] == (a[i] | b[i]));
+         assert(andWords(dst, a, b, n) == andBits);
+         for (int i = 0; i < n; i++) assert(dst[i] == (a[i] & b[i]));
+         assert(andNotWords(dst, a, b, n) == andNotBits);
+         for (int i = 0; i < n; i++) assert(dst[i] == (a[i] & ~b[i]));
+         assert(andCountWords(a, b, n) == andBits);
+         assert(anyAndWords(a, b, n) == any);
+         assert(popcountWords(a, n) == bits);
+         assert(equalWords(a, a, n));
+         if (n > 0) {
+            copy(a, a + n, dst);
+            dst[n - 1] ^= 1;
+            assert(!equalWords(a, dst, n));
+         }
+      }
+
+      // dst may be the same array as a
+      copy(a, a + maxWords, dst);
+      orWords(dst, dst, b, maxWords);
+      for (int i = 0; i < maxWords; i++) assert(dst[i] == (a[i] | b[i]));
+
+      IntSet both = x * y;
+      checkSame(both, expected);
+      assert(x.intersectionCount(y) == static_cast<int>(expected.size()));
+   }
+
+   assert(setKernelIsa(best));
+   cout << "Ending testKernels" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testRankSelect
+// rank and select against positions in a std::set, before and after
+// changes that must rebuild the rank directory
+static void testRankSelect()
+{
+   cout << "Starting testRankSelect" << endl;
+
+   IntSet a, empty;
+   set<int> s;
+   assert(empty.rank(0) == 0 && empty.rank(100) == 0);
+   assert(empty.select(0) == -1 && empty.select(-1) == -1);
+   assert(popcount64(0) == 0 && popcount64(~uint64_t(0)) == 64);
+   assert(popcountWord(0x8000000000000001ULL) == 2);
+
+   randomSet(a, s, 4000, 30000, 6);
+   for (int round = 0; round < 2; round++) {
+      vector<int> members(s.begin(), s.end());
+      int size = static_cast<int>(members.size());
+      for (int k = 0; k < size; k++) {
+         assert(a.select(k) == members[k]);
+         assert(a.rank(members[k]) == k);
+         assert(a.rank(members[k] + 1) == k + 1);
+      }
+      assert(a.select(size) == -1 && a.select(-5) == -1);
+      assert(a.rank(-3) == 0 && a.rank(0) == 0);
+      assert(a.rank(40000) == size);
+
+      // every rank(n) against a count of members below n
+      int below = 0;
+      for (int n = 0; n <= 30001; n++) {
+         assert(a.rank(n) == below);
+         below += static_cast<int>(s.count(n));
+      }
+
+      // change the set, which has to rebuild the directory
+      for (int n = 0; n < 30000; n += 7) {
+         if (a.remove(n)) s.erase(n);
+      }
+      a.insertRange(10000, 10700);
+      for (int n = 10000; n <= 10700; n++) s.insert(n);
+   }
+
+   cout << "Ending testRankSelect" << endl;
+}
+
+// --------------------------------------------------------------------------
+// checkSparse
+// Asserts that a SparseIntSet has exactly the members of s
+static void checkSparse(const SparseIntSet& actual, const set<int>& s)
+{
+   assert(actual.size() == static_cast<int>(s.size()));
+   assert(actual.isEmpty() == s.empty());
+   assert(toString(actual) == toString(s));
+   for (int n : s) {
+      assert(actual.isInSet(n));
+      assert(n == INT_MAX || !actual.isInSet(n + 1) || s.count(n + 1) == 1);
+   }
+}
+
+// --------------------------------------------------------------------------
+// checkSparseAlgebra
+// Checks every operator of x and y (either order) against std::set
+static void checkSparseAlgebra(const SparseIntSet& x, const set<int>& xs,
+   const SparseIntSet& y, const set<int>& ys)
+{
+   for (int order = 0; order < 2; order++) {
+      const SparseIntSet& l = (order == 0) ? x : y;
+      const SparseIntSet& r = (order == 0) ? y : x;
+      const set<int>& ls = (order == 0) ? xs : ys;
+      const set<int>& rs = (order == 0) ? ys : xs;
+
+      set<int> expected;
+      set_union(ls.begin(), ls.end(), rs.begin(), rs.end(),
+         inserter(expected, expected.end()));
+      checkSparse(l + r, expected);
+      SparseIntSet assigned(l);
+      assigned += r;
+      checkSparse(assigned, expected);
+
+      expected.clear();
+      set_intersection(ls.begin(), ls.end(), rs.begin(), rs.end(),
+         inserter(expected, expected.end()));
+      checkSparse(l * r, expected);
+      assigned = l;
+      assigned *= r;
+      checkSparse(assigned, expected);
+
+      expected.clear();
+      set_difference(ls.begin(), ls.end(), rs.begin(), rs.end(),
+         inserter(expected, expected.end()));
+      checkSparse(l - r, expected);
+      assigned = l;
+      assigned -= r;
+      checkSparse(assigned, expected);
+   }
+}
+
+// --------------------------------------------------------------------------
+// testSparseIntSet
+// SparseIntSet against std::set across container limits (4096 members
+// for an array), run splits and merges, optimize(), and set algebra on
+// chunks held in different container types
+static void testSparseIntSet()
+{
+   cout << "Starting testSparseIntSet" << endl;
+
+   SparseIntSet a(5, 70000, -1, 5, 1 << 30), empty;
+   set<int> s = { 5, 70000, 1 << 30 };
+   checkSparse(a, s);
+   checkSparse(empty, set<int>());
+   assert(toString(empty) == "{}");
+
+   // one chunk growing past an array's 4096 members into a bitmap and
+   // shrinking back, both ends of the chunk included
+   const int base = 3 << 16;
+   SparseIntSet grow;
+   set<int> gs;
+   for (int i = 0; i < 4200; i++) {
+      int n = base + (i * 15) % 65536;
+      assert(grow.insert(n) == gs.insert(n).second);
+      if (i >= 4090 && i <= 4100) checkSparse(grow, gs);
+   }
+   assert(grow.insert(base + 65535) && grow.insert(base + 1));
+   gs.insert(base + 65535);
+   gs.insert(base + 1);
+   checkSparse(grow, gs);
+   for (int i = 0; i < 4200; i += 2) {
+      int n = base + (i * 15) % 65536;
+      assert(grow.remove(n) == (gs.erase(n) == 1));
+   }
+   assert(!grow.remove(base + 2) && !grow.remove(-1));
+   checkSparse(grow, gs);
+
+   // runs: filling the gaps of a bitmap leaves one long range, which
+   // optimize() turns into a run taking far less memory; then removes
+   // split the run and inserts merge it back
+   SparseIntSet runs;
+   set<int> rs;
+   for (int n = 1000; n <= 60000; n += 2) {
+      runs.insert(n);
+      rs.insert(n);
+   }
+   for (int n = 1001; n < 60000; n += 2) {
+      runs.insert(n);
+      rs.insert(n);
+   }
+   for (int n = 200000; n < 200050; n++) {
+      runs.insert(n);
+      rs.insert(n);
+   }
+   long long before = runs.memoryUsage();
+   runs.optimize();
+   checkSparse(runs, rs);
+   assert(runs.memoryUsage() < before / 4);
+   for (int n = 2000; n < 60000; n += 1000) {
+      assert(runs.remove(n));
+      rs.erase(n);
+   }
+   assert(runs.remove(1000) && runs.remove(60000) && !runs.remove(2000));
+   rs.erase(1000);
+   rs.erase(60000);
+   checkSparse(runs, rs);
+   for (int n = 2000; n < 60000; n += 1000) {
+      assert(runs.insert(n));
+      rs.insert(n);
+   }
+   assert(runs.insert(999) && runs.insert(60000) && !runs.insert(5000));
+   rs.insert(999);
+   rs.insert(60000);
+   checkSparse(runs, rs);
+
+   // a run list that splits past its limit becomes a bitmap
+   for (int n = 1001; n < 60000; n += 2) {
+      runs.remove(n);
+      rs.erase(n);
+   }
+   checkSparse(runs, rs);
+
+   // set algebra on the same chunks held as array, bitmap and run
+   // containers, and on chunks only one side has
+   SparseIntSet sparse, dense, ranged;
+   set<int> ss, ds, rgs;
+   mt19937 rng(7);
+   for (int i = 0; i < 3000; i++) {
+      int n = static_cast<int>(rng() % (1 << 18));
+      sparse.insert(n);
+      ss.insert(n);
+   }
+   for (int i = 0; i < 30000; i++) {
+      int n = static_cast<int>(rng() % (1 << 17));
+      dense.insert(n);
+      ds.insert(n);
+   }
+   for (int first = 0; first < (1 << 18); first += 5000) {
+      for (int n = first; n < first + 2000; n++) {
+         ranged.insert(n);
+         rgs.insert(n);
+      }
+   }
+   ranged.optimize();
+   checkSparseAlgebra(sparse, ss, dense, ds);
+   checkSparseAlgebra(sparse, ss, ranged, rgs);
+   checkSparseAlgebra(dense, ds, ranged, rgs);
+   checkSparseAlgebra(a, s, empty, set<int>());
+
+   // a run that ends at the largest possible member
+   SparseIntSet top;
+   set<int> ts;
+   for (int offset = 9999; offset >= 0; offset--) {
+      top.insert(INT_MAX - offset);
+      ts.insert(INT_MAX - offset);
+   }
+   top.optimize();
+   assert(top.memoryUsage() < 1000);
+   checkSparse(top, ts);
+   assert(top.remove(INT_MAX) && top.insert(INT_MAX));
+   checkSparseAlgebra(top, ts, ranged, rgs);
+
+   // equality does not depend on container types
+   SparseIntSet copy(ranged);
+   assert(copy == ranged && !(copy != ranged));
+   SparseIntSet rebuilt;
+   for (int n : rgs) rebuilt.insert(n);
+   assert(rebuilt == ranged);
+   rebuilt.remove(*rgs.rbegin());
+   assert(rebuilt != ranged);
+
+   // >> reads a line like IntSet's, and stops at the end of the input
+   istringstream input("1 2 -3 x4 70000 2147483648 2147483647\n\n 9\n");
+   SparseIntSet line;
+   assert(input >> line);
+   checkSparse(line, set<int>{ 1, 2, 4, 70000, 2147483647 });
+   assert(input >> line);
+   assert(line.isInSet(9) && line.size() == 6);
+   assert(!(input >> line));
+   assert(line.size() == 6);
+   istringstream noNewline("1 2 3");
+   SparseIntSet last;
+   while (noNewline >> last) {}
+   checkSparse(last, set<int>{ 1, 2, 3 });
+
+   cout << "Ending testSparseIntSet" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testMoveAndGrowth
+// Moved-from sets are empty and still usable, and inserting ascending
+// integers grows the word array a logarithmic number of times
+static void testMoveAndGrowth()
+{
+   cout << "Starting testMoveAndGrowth" << endl;
+
+   IntSet a;
+   set<int> s;
+   randomSet(a, s, 2000, 50000, 8);
+   assert(a.rank(25000) == static_cast<int>(distance(s.begin(),
+      s.lower_bound(25000))));
+
+   IntSet moved(std::move(a));
+   checkSame(moved, s);
+   checkSame(a, set<int>());
+   assert(a.rank(10) == 0 && a.select(0) == -1 && a.begin() == a.end());
+
+   // a moved-from set works as an empty operand and as a target
+   checkSame(moved + a, s);
+   checkSame(moved * a, set<int>());
+   checkSame(a - moved, set<int>());
+   assert(a == IntSet() && a != moved);
+   assert(a.insert(70000) && a.isInSet(70000));
+   a.remove(70000);
+
+   IntSet target(1, 2, 3);
+   target = std::move(moved);
+   checkSame(target, s);
+   checkSame(moved, set<int>());
+   moved = target;
+   checkSame(moved, s);
+   IntSet& alias = target;
+   target = std::move(alias);
+   checkSame(target, s);
+   moved = std::move(a);
+   checkSame(moved, set<int>());
+
+   // geometric growth: few different sizes for 2^20 ascending inserts
+   IntSet grown;
+   long long lastBytes = grown.memoryUsage();
+   int resizes = 0;
+   for (int n = 0; n < (1 << 20); n++) {
+      grown.insert(n);
+      if (grown.memoryUsage() != lastBytes) {
+         assert(grown.memoryUsage() > lastBytes);
+         lastBytes = grown.memoryUsage();
+         resizes++;
+      }
+   }
+   assert(resizes <= 20 && grown.size() == (1 << 20));
+   assert(grown.isInSet(0) && grown.isInSet((1 << 20) - 1));
+   assert(!grown.isInSet(1 << 20));
+   assert(grown.memoryUsage() < 2 * ((1 << 20) / 8) + 4096);
+
+   // a large insert into a small set grows straight to the needed size
+   IntSet jump(5);
+   assert(jump.insert(10000000) && jump.size() == 2);
+   checkSame(jump, set<int>{ 5, 10000000 });
+
+   cout << "Ending testMoveAndGrowth" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testBatches
+// Batch insert and remove from arrays and other containers, the iterator
+// constructor, and insertRange across word boundaries
+static void testBatches()
+{
+   cout << "Starting testBatches" << endl;
+
+   // duplicates and negatives in a batch, more values than one local copy
+   vector<int> values;
+   mt19937 rng(9);
+   for (int i = 0; i < 5000; i++) {
+      values.push_back(static_cast<int>(rng() % 20000) - 1000);
+   }
+   set<int> s;
+   for (int n : values) {
+      if (n >= 0) s.insert(n);
+   }
+
+   IntSet fromArray;
+   assert(fromArray.insertBatch(values.data(), static_cast<int>(
+      values.size())) == static_cast<int>(s.size()));
+   checkSame(fromArray, s);
+   assert(fromArray.insertBatch(values.data(), 0) == 0);
+   assert(fromArray.insertBatch(values.data(), static_cast<int>(
+      values.size())) == 0);
+
+   IntSet fromRange(values.begin(), values.end());
+   checkSame(fromRange, s);
+   // iterators without random access
+   set<int> ordered(values.begin(), values.end());
+   IntSet fromSet(ordered.begin(), ordered.end());
+   checkSame(fromSet, s);
+   int array[] = { 3, -1, 64, 3 };
+   IntSet fromPlainArray(array, array + 4);
+   checkSame(fromPlainArray, set<int>{ 3, 64 });
+
+   // remove every other value, then the same ones again
+   vector<int> half;
+   for (size_t i = 0; i < values.size(); i += 2) half.push_back(values[i]);
+   int removed = 0;
+   for (int n : half) {
+      if (n >= 0) removed += static_cast<int>(s.erase(n));
+   }
+   assert(fromRange.removeBatch(half.begin(), half.end()) == removed);
+   assert(fromArray.removeBatch(half.data(),
+      static_cast<int>(half.size())) == removed);
+   assert(fromArray.removeBatch(half.data(),
+      static_cast<int>(half.size())) == 0);
+   checkSame(fromRange, s);
+   checkSame(fromArray, s);
+
+   // removing the largest members lowers maxNum, so a later == still holds
+   int top[] = { *s.rbegin(), 1000000 };
+   assert(fromArray.removeBatch(top, 2) == 1);
+   s.erase(*s.rbegin());
+   checkSame(fromArray, s);
+   assert(fromArray == IntSet(s.begin(), s.end()));
+
+   // insertRange: inside one word, across words, over existing members
+   IntSet ranged;
+   set<int> rs;
+   const int ranges[][2] = { { 5, 5 }, { 10, 20 }, { 60, 70 }, { 64, 127 },
+      { 100, 400 }, { 1000, 1063 }, { -50, 2 }, { 30, 29 }, { 2000, 10000 },
+      { 9000, 9100 } };
+   for (const int* r : ranges) {
+      int expected = 0;
+      for (int n = (r[0] < 0 ? 0 : r[0]); n <= r[1]; n++) {
+         expected += rs.insert(n).second ? 1 : 0;
+      }
+      assert(ranged.insertRange(r[0], r[1]) == expected);
+      checkSame(ranged, rs);
+   }
+   assert(ranged.insertRange(-10, -1) == 0);
+   assert(ranged.rank(2001) == static_cast<int>(distance(rs.begin(),
+      rs.find(2001))));
+
+   cout << "Ending testBatches" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testIterators
+// Forward and reverse iteration and forEach visit the members of a
+// std::set in the same order, including 0 and INT_MAX
+static void testIterators()
+{
+   cout << "Starting testIterators" << endl;
+
+   IntSet empty;
+   assert(empty.begin() == empty.end() && empty.rbegin() == empty.rend());
+
+   IntSet a;
+   set<int> s;
+   randomSet(a, s, 3000, 200000, 10);
+   a.insert(0);
+   s.insert(0);
+   for (int n = 100000; n < 100200; n++) {
+      a.insert(n);
+      s.insert(n);
+   }
+
+   vector<int> forward(a.begin(), a.end());
+   assert(forward == vector<int>(s.begin(), s.end()));
+   vector<int> backward(a.rbegin(), a.rend());
+   assert(backward == vector<int>(s.rbegin(), s.rend()));
+   vector<int> visited;
+   a.forEach([&visited](int n) { visited.push_back(n); });
+   assert(visited == forward);
+
+   // stepping both ways from the middle, and back from end()
+   IntSet::const_iterator it = a.begin();
+   set<int>::const_iterator expected = s.begin();
+   for (int i = 0; i < 1500; i++, ++it, ++expected) {}
+   assert(*it == *expected);
+   assert(*it++ == *expected++ && *it == *expected);
+   assert(*--it == *--expected);
+   IntSet::const_iterator last = a.end();
+   --last;
+   assert(*last == *s.rbegin());
+   assert(++last == a.end());
+
+   // the largest possible member: ++ must end instead of wrapping
+   IntSet edge(5, INT_MAX);
+   vector<int> edgeMembers(edge.begin(), edge.end());
+   assert((edgeMembers == vector<int>{ 5, INT_MAX }));
+   vector<int> edgeReverse(edge.rbegin(), edge.rend());
+   assert((edgeReverse == vector<int>{ INT_MAX, 5 }));
+   IntSet::const_iterator top = edge.end();
+   --top;
+   assert(*top == INT_MAX && ++top == edge.end());
+   assert(edge.rank(INT_MAX) == 1 && edge.select(1) == INT_MAX);
+
+   cout << "Ending testIterators" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testBinary
+// Round trips through a stream, a file and a mapped view, and corrupt or
+// truncated data that must be rejected without changing the set
+static void testBinary()
+{
+   cout << "Starting testBinary" << endl;
+
+   IntSet a, empty;
+   set<int> s;
+   randomSet(a, s, 5000, 100000, 11);
+
+   for (const IntSet* original : { &a, &empty }) {
+      const set<int>& expected = (original == &a) ? s : set<int>();
+      stringstream buffer;
+      assert(original->writeBinary(buffer));
+      IntSet read(7);
+      assert(read.readBinary(buffer));
+      checkSame(read, expected);
+      assert(!read.isView());
+   }
+
+   const char* path = "intsettest.bin";
+   assert(a.writeBinary(path));
+   IntSet mapped(1, 2), verified;
+   assert(verified.mapBinary(path, true));
+   checkSame(verified, s);
+   assert(mapped.mapBinary(path));
+   assert(mapped.isView());
+   checkSame(mapped, s);
+   assert(mapped.rank(50000) == a.rank(50000));
+   mapped.insert(200000);
+   assert(!mapped.isView() && mapped.isInSet(200000));
+   mapped.remove(200000);
+   checkSame(mapped, s);
+
+   // the file's bytes, to corrupt one field at a time
+   ostringstream bytes;
+   assert(a.writeBinary(bytes));
+   const string good = bytes.str();
+   const size_t countAt = 12;
+   const size_t maxNumAt = 8;
+
+   string wrongCount = good;
+   wrongCount[countAt]++;
+   string wrongMax = good;
+   wrongMax[maxNumAt]--;
+   string highBit = good;
+   highBit[good.size() - 1] = static_cast<char>(0x80);
+   assert(a.select(a.size() - 1) % 64 != 63);
+   string truncated = good.substr(0, good.size() - 3);
+   string badMagic = good;
+   badMagic[0] = 'X';
+
+   for (const string* data : { &wrongCount, &wrongMax, &highBit,
+      &truncated, &badMagic }) {
+      IntSet target(3, 4);
+      istringstream input(*data);
+      assert(!target.readBinary(input));
+      checkSame(target, set<int>{ 3, 4 });
+
+      {
+         ofstream file(path, ios::binary);
+         file << *data;
+      }
+      // opening only checks the count when asked to verify
+      assert(!target.mapBinary(path, true));
+      assert(target.mapBinary(path) == (data == &wrongCount));
+      if (target.isView()) target = IntSet(3, 4);
+      checkSame(target, set<int>{ 3, 4 });
+   }
+   IntSet target(3);
+   assert(!target.mapBinary("intsettest-missing.bin"));
+   remove(path);
+
+   cout << "Ending testBinary" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testConcurrentIntSet
+// Threads inserting and removing at once leave exactly the members a
+// single thread would, and size() counts them once the threads are done
+static void testConcurrentIntSet()
+{
+   cout << "Starting testConcurrentIntSet" << endl;
+
+   ConcurrentIntSet empty(0);
+   assert(empty.isEmpty() && empty.capacity() == 0 && !empty.insert(0));
+
+   const int capacity = 1 << 18;
+   const int threads = 8;
+   ConcurrentIntSet shared(capacity);
+   assert(!shared.insert(-1) && !shared.insert(capacity));
+   assert(shared.insert(capacity - 1) && shared.remove(capacity - 1));
+
+   // the largest capacity: members up to INT_MAX - 1
+   {
+      ConcurrentIntSet huge(INT_MAX);
+      assert(huge.capacity() == INT_MAX && huge.isEmpty());
+      assert(huge.insert(INT_MAX - 1) && !huge.insert(INT_MAX));
+      assert(huge.insert(0) && huge.size() == 2);
+      assert(huge.isInSet(INT_MAX - 1) && !huge.isInSet(INT_MAX - 2));
+      checkSame(huge.toIntSet(), set<int>{ 0, INT_MAX - 1 });
+   }
+
+   // first every thread inserts its own residue class below half and all
+   // of the shared range above it; then every thread removes its multiples
+   // of 3 and the even members of the shared range
+   const int half = capacity / 2;
+   vector<thread> workers;
+   for (int t = 0; t < threads; t++) {
+      workers.push_back(thread([&shared, t, half] {
+         for (int n = t; n < half; n += threads) shared.insert(n);
+         for (int n = half; n < half + 4096; n++) shared.insert(n);
+      }));
+   }
+   for (thread& worker : workers) worker.join();
+   assert(shared.size() == half + 4096);
+
+   workers.clear();
+   for (int t = 0; t < threads; t++) {
+      workers.push_back(thread([&shared, t, half] {
+         for (int n = t; n < half; n += threads) {
+            if (n % 3 == 0) shared.remove(n);
+         }
+         for (int n = half; n < half + 4096; n += 2) shared.remove(n);
+      }));
+   }
+   for (thread& worker : workers) worker.join();
+
+   set<int> expected;
+   for (int n = 0; n < half; n++) {
+      if (n % 3 != 0) expected.insert(n);
+   }
+   for (int n = half + 1; n < half + 4096; n += 2) expected.insert(n);
+   checkSame(shared.toIntSet(), expected);
+   assert(shared.size() == static_cast<int>(expected.size()));
+   assert(!shared.isEmpty() && !shared.isInSet(3) && shared.isInSet(4));
+   assert(toString(shared) == toString(expected));
+
+   // every thread racing for the same members: each is counted once
+   ConcurrentIntSet contested(1000);
+   atomic<int> wins(0);
+   workers.clear();
+   for (int t = 0; t < threads; t++) {
+      workers.push_back(thread([&contested, &wins] {
+         for (int n = 0; n < 1000; n++) {
+            if (contested.insert(n)) wins++;
+         }
+      }));
+   }
+   for (thread& worker : workers) worker.join();
+   assert(wins == 1000 && contested.size() == 1000);
+
+   cout << "Ending testConcurrentIntSet" << endl;
+}
+
+// --------------------------------------------------------------------------
+// setUnion, setIntersection, setDifference
+// std::set versions of +, * and - for the expression tests
+static set<int> setUnion(const set<int>& x, const set<int>& y)
+{
+   set<int> result(x);
+   result.insert(y.begin(), y.end());
+   return result;
+}
+
+static set<int> setIntersection(const set<int>& x, const set<int>& y)
+{
+   set<int> result;
+   for (int n : x) {
+      if (y.count(n) == 1) result.insert(n);
+   }
+   return result;
+}
+
+static set<int> setDifference(const set<int>& x, const set<int>& y)
+{
+   set<int> result;
+   for (int n : x) {
+      if (y.count(n) == 0) result.insert(n);
+   }
+   return result;
+}
+
+// --------------------------------------------------------------------------
+// testExpressions
+// Chained expressions against std::set, including results assigned to
+// one of their own operands, and expressions used without assigning them
+static void testExpressions()
+{
+   cout << "Starting testExpressions" << endl;
+
+   IntSet a, b, c, d;
+   set<int> as, bs, cs, ds;
+   randomSet(a, as, 3000, 30000, 12);
+   randomSet(b, bs, 3000, 50000, 13);
+   randomSet(c, cs, 5000, 20000, 14);
+   randomSet(d, ds, 100, 1000, 15);
+
+   IntSet e = (a + b) * c - d;
+   set<int> expected = setDifference(setIntersection(setUnion(as, bs), cs),
+      ds);
+   checkSame(e, expected);
+
+   // the result replaces an operand that is read more than once, with the
+   // operands longer and shorter than the result
+   b = (a + b) * c - b;
+   bs = setDifference(setIntersection(setUnion(as, bs), cs), bs);
+   checkSame(b, bs);
+
+   a = a + a;
+   checkSame(a, as);
+   a = a - a;
+   checkSame(a, set<int>());
+   a = (c - d) + (d * c) + a;
+   as = setUnion(setDifference(cs, ds), setIntersection(ds, cs));
+   checkSame(a, as);
+   d = d + (c - a) * d + b;
+   ds = setUnion(setUnion(ds, setIntersection(setDifference(cs, as), ds)),
+      bs);
+   checkSame(d, ds);
+   c = d - (c + d);
+   checkSame(c, set<int>());
+
+   // a target that is an operand and has to grow to hold the result
+   IntSet small(1, 2);
+   small = (small + d) - (e * small);
+   checkSame(small, setDifference(setUnion(set<int>{ 1, 2 }, ds),
+      setIntersection(expected, set<int>{ 1, 2 })));
+
+   // expressions asked about directly, without a set being built
+   set<int> sum = setUnion(setIntersection(as, bs), ds);
+   assert((a * b + d).size() == static_cast<int>(sum.size()));
+   assert((a - a + c).isEmpty() && !(a * b + d).isEmpty());
+   for (int n = 0; n < 1200; n++) {
+      assert((a * b + d).isInSet(n) == (sum.count(n) == 1));
+   }
+   assert(toString(a * b + d) == toString(sum));
+   assert(a * b + d == d + b * a && a + d != a * d);
+   assert(IntSet(a * b + d) == a * b + d);
+
+   cout << "Ending testExpressions" << endl;
+}
+
+// --------------------------------------------------------------------------
+// parseSlowly
+// The members >> should find in text, one character at a time: digit
+// runs not right after a '-' whose value fits in an int
+static set<int> parseSlowly(const string& text)
+{
+   set<int> members;
+   for (size_t i = 0; i < text.size();) {
+      if (text[i] < '0' || text[i] > '9') {
+         i++;
+         continue;
+      }
+      bool negative = i > 0 && text[i - 1] == '-';
+      long long value = 0;
+      for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+         if (value <= INT_MAX) value = value * 10 + (text[i] - '0');
+      }
+      if (!negative && value <= INT_MAX) {
+         members.insert(static_cast<int>(value));
+      }
+   }
+   return members;
+}
+
+// --------------------------------------------------------------------------
+// testScanner
+// insertText, insertTextFile and >> against a character-at-a-time parse:
+// overflow, signs, numbers of every length around 8 digits, and numbers
+// cut by the stream's block boundaries
+static void testScanner()
+{
+   cout << "Starting testScanner" << endl;
+
+   const string edges = "0 7 -5 -0 12-3 x4 +6 1.5 00000000000000000042 "
+      "12345678 123456789 1234567 99999999 100000000 2147483647 2147483648 "
+      "4294967296 99999999999999999999999 -2147483648 21474836470";
+   IntSet a;
+   set<int> s = parseSlowly(edges);
+   assert((s == set<int>{ 0, 7, 12, 4, 6, 1, 5, 42, 12345678, 123456789,
+      1234567, 99999999, 100000000, INT_MAX }));
+   assert(a.insertText(edges.data(), edges.size()) ==
+      static_cast<int>(s.size()));
+   checkSame(a, s);
+
+   // random text: numbers of 1 to 12 digits between random separators
+   mt19937 rng(16);
+   const char separators[] = " \t\n,-x-";
+   string text;
+   while (text.size() < 3000000) {
+      int digits = 1 + static_cast<int>(rng() % 12);
+      for (int i = 0; i < digits; i++) {
+         text += static_cast<char>('0' + rng() % 10);
+      }
+      int gap = 1 + static_cast<int>(rng() % 3);
+      for (int i = 0; i < gap; i++) text += separators[rng() % 7];
+   }
+   s = parseSlowly(text);
+   IntSet fromMemory;
+   fromMemory.insertText(text.data(), text.size());
+   checkSame(fromMemory, s);
+
+   // a stream is read in blocks, so numbers are split across them
+   istringstream stream(text);
+   IntSet fromStream;
+   assert(fromStream.insertText(stream) == static_cast<int>(s.size()));
+   checkSame(fromStream, s);
+
+   const char* path = "intsettest.txt";
+   {
+      ofstream file(path, ios::binary);
+      file << text;
+   }
+   IntSet fromFile;
+   assert(fromFile.insertTextFile(path));
+   checkSame(fromFile, s);
+   assert(!fromFile.insertTextFile("intsettest-missing.txt"));
+
+   // a block of nothing but digits is one number too large for an int
+   string digitsOnly(3000000, '9');
+   digitsOnly += " 17";
+   istringstream longRun(digitsOnly);
+   IntSet fromLongRun;
+   fromLongRun.insertText(longRun);
+   checkSame(fromLongRun, set<int>{ 17 });
+   remove(path);
+
+   // a '-' or a digit that ends a block still belongs to the number at
+   // the start of the next one (the stream is read 1 MB at a time)
+   const size_t block = 1 << 20;
+   for (const char* tail : { "-", "-1", "1", " " }) {
+      string boundary(block - strlen(tail), ' ');
+      boundary += tail;
+      boundary += "5 7";
+      istringstream blocks(boundary);
+      IntSet fromBlocks, inMemory;
+      fromBlocks.insertText(blocks);
+      inMemory.insertText(boundary.data(), boundary.size());
+      checkSame(fromBlocks, parseSlowly(boundary));
+      assert(fromBlocks == inMemory);
+   }
+
+   // >> reads one line at a time, skipping blank lines first
+   istringstream lines("1 2 -3\n\n\n 40 x50\n60");
+   IntSet line;
+   assert(lines >> line);
+   checkSame(line, set<int>{ 1, 2 });
+   assert(lines >> line);
+   checkSame(line, set<int>{ 1, 2, 40, 50 });
+   assert(lines >> line);
+   checkSame(line, set<int>{ 1, 2, 40, 50, 60 });
+   assert(!(lines >> line));
+
+   cout << "Ending testScanner" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testCounting
+// intersectionCount, unionCount, differenceCount, jaccard and intersects
+// against the sizes of std::set results, for sets of different lengths
+static void testCounting()
+{
+   cout << "Starting testCounting" << endl;
+
+   IntSet a, b, far, empty;
+   set<int> as, bs, fs;
+   randomSet(a, as, 4000, 40000, 17);
+   randomSet(b, bs, 300, 3000, 18);
+   for (int n = 100000; n < 100500; n++) {
+      far.insert(n);
+      fs.insert(n);
+   }
+
+   const IntSet* sets[] = { &a, &b, &far, &empty };
+   const set<int>* stdSets[] = { &as, &bs, &fs, NULL };
+   set<int> none;
+   for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+         const IntSet& x = *sets[i];
+         const IntSet& y = *sets[j];
+         const set<int>& xs = stdSets[i] ? *stdSets[i] : none;
+         const set<int>& ys = stdSets[j] ? *stdSets[j] : none;
+
+         int common = static_cast<int>(setIntersection(xs, ys).size());
+         int all = static_cast<int>(setUnion(xs, ys).size());
+         assert(x.intersectionCount(y) == common);
+         assert(x.unionCount(y) == all);
+         assert(x.differenceCount(y) ==
+            static_cast<int>(setDifference(xs, ys).size()));
+         assert(x.intersects(y) == (common > 0));
+         double expected = (all == 0) ? 1.0 :
+            static_cast<double>(common) / all;
+         assert(x.jaccard(y) == expected);
+         assert(x.jaccard(y) == y.jaccard(x));
+      }
+   }
+
+   // one common member at the very end
+   IntSet last(99999), other(100499);
+   assert(!last.intersects(far) && other.intersects(far));
+   assert(other.intersectionCount(far) == 1 && a.jaccard(a) == 1.0);
+
+   cout << "Ending testCounting" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testWorkerPool
+// Every task runs exactly once for any number of threads, runs can follow
+// each other, and two threads calling run take turns
+static void testWorkerPool()
+{
+   cout << "Starting testWorkerPool" << endl;
+
+   WorkerPool pool;
+   assert(WorkerPool::hardwareThreads() >= 1);
+   for (int threads : { 1, 2, 3, 0, 16 }) {
+      for (int tasks : { 0, 1, 5, 1000 }) {
+         vector<atomic<int>> runs(tasks);
+         for (atomic<int>& r : runs) r = 0;
+         pool.run(tasks, threads, [&runs](int i) { runs[i]++; });
+         for (atomic<int>& r : runs) assert(r == 1);
+      }
+   }
+
+   atomic<long long> total(0);
+   vector<thread> callers;
+   for (int c = 0; c < 3; c++) {
+      callers.push_back(thread([&pool, &total] {
+         for (int round = 0; round < 20; round++) {
+            pool.run(100, 4, [&total](int i) { total += i; });
+         }
+      }));
+   }
+   for (thread& caller : callers) caller.join();
+   assert(total == 3LL * 20 * (99 * 100 / 2));
+
+   cout << "Ending testWorkerPool" << endl;
+}
+
+// --------------------------------------------------------------------------
+// testParallel
+// Each parallel operation gives the same set as the serial operator for
+// several thread counts, on sets several 16384-word chunks long and of
+// different lengths
+static void testParallel()
+{
+   cout << "Starting testParallel" << endl;
+
+   IntSet big, mid, copy, empty;
+   set<int> bigSet, midSet;
+   randomSet(big, bigSet, 200000, 5000000, 19);
+   randomSet(mid, midSet, 100000, 2500000, 20);
+   big.insertRange(1048576, 1200000);
+   for (int n = 1048576; n <= 1200000; n++) bigSet.insert(n);
+   copy = big;
+   checkSame(big.parallelUnion(mid, 3), setUnion(bigSet, midSet));
+
+   const IntSet* sets[] = { &big, &mid, &empty };
+   for (int threads : { 1, 2, 3, 0, 64 }) {
+      for (const IntSet* x : sets) {
+         for (const IntSet* y : sets) {
+            IntSet united = x->parallelUnion(*y, threads);
+            IntSet both = x->parallelIntersection(*y, threads);
+            IntSet only = x->parallelDifference(*y, threads);
+            assert(united == *x + *y && united.size() == (*x + *y).size());
+            assert(both == *x * *y && both.size() == (*x * *y).size());
+            assert(only == *x - *y && only.size() == (*x - *y).size());
+            assert(x->parallelEquals(*y, threads) == (*x == *y));
+         }
+      }
+
+      // a difference in the first or the last word, and equal members in
+      // word arrays of different lengths
+      assert(big.parallelEquals(copy, threads));
+      copy.remove(*copy.begin());
+      assert(!big.parallelEquals(copy, threads));
+      copy.insert(*big.begin());
+      int top = *big.rbegin();
+      copy.remove(top);
+      assert(!copy.parallelEquals(big, threads));
+      copy.insert(top);
+      copy.insert(9000000);
+      copy.remove(9000000);
+      assert(copy.parallelEquals(big, threads));
+
+      // disjoint sets intersect to an empty set
+      IntSet low, high;
+      low.insertRange(0, 1000000);
+      high.insertRange(1000001, 3000000);
+      IntSet none = low.parallelIntersection(high, threads);
+      assert(none.isEmpty() && none == IntSet());
+      assert(low.parallelDifference(high, threads) == low);
+   }
+
+   cout << "Ending testParallel" << endl;
+}
+
+// FixedIntSet built and combined at compile time, across the word
+// boundaries of a 130-member universe; a regression fails the build
+constexpr FixedIntSet<130> FIXED_A{ 0, 63, 64, 127, 128, 129 };
+constexpr FixedIntSet<130> FIXED_B{ 1, 64, 129, 130, -1 };
+
+// --------------------------------------------------------------------------
+// fixedCompound
+// Returns a FixedIntSet changed by every mutating operation, for use in a
+// constant expression
+constexpr FixedIntSet<130> fixedCompound()
+{
+   FixedIntSet<130> set{ 5 };
+   set += FIXED_A;
+   set -= FixedIntSet<130>{ 0 };
+   set.remove(63);
+   set.insert(100);
+   set *= FixedIntSet<130>{ 5, 64, 100, 128 };
+   return set;
+}
+
+static_assert(FIXED_A.size() == 6 && FIXED_B.size() == 3,
+   "out of range members are ignored");
+static_assert(FIXED_A.isInSet(128) && !FIXED_B.isInSet(130) &&
+   !FIXED_B.isInSet(-1), "isInSet");
+static_assert((FIXED_A + FIXED_B).size() == 7, "union");
+static_assert(FIXED_A * FIXED_B == FixedIntSet<130>{ 64, 129 },
+   "intersection");
+static_assert(FIXED_A - FIXED_B == FixedIntSet<130>{ 0, 63, 127, 128 },
+   "difference");
+static_assert(FIXED_A != FIXED_B && FixedIntSet<130>().isEmpty(),
+   "comparison");
+static_assert(fixedCompound() == FixedIntSet<130>{ 5, 64, 100, 128 },
+   "compound operators, insert and remove");
+static_assert(FIXED_B.word(2) == 2 && FixedIntSet<130>::WORDS == 3,
+   "word layout");
+
+// --------------------------------------------------------------------------
+// checkFixed
+// Asserts that a FixedIntSet has exactly the members of s
+template<int N>
+static void checkFixed(const FixedIntSet<N>& actual, const set<int>& s)
+{
+   assert(actual.size() == static_cast<int>(s.size()));
+   assert(actual.isEmpty() == s.empty());
+   assert(toString(actual) == toString(s));
+   for (int n = -1; n <= N; n++) {
+      assert(actual.isInSet(n) == (s.count(n) == 1));
+   }
+}
+
+// --------------------------------------------------------------------------
+// testFixedUniverse
+// Random inserts and removes and every operator of FixedIntSet<N>
+// against std::set
+template<int N>
+static void testFixedUniverse(unsigned seed)
+{
+   mt19937 rng(seed);
+   FixedIntSet<N> x, y;
+   set<int> xs, ys;
+   for (int i = 0; i < 4 * N; i++) {
+      int n = static_cast<int>(rng() % (N + 4)) - 2;
+      bool valid = n >= 0 && n < N;
+      if (rng() % 3 != 0) {
+         assert(x.insert(n) == (valid && xs.insert(n).second));
+      }
+      else {
+         assert(x.remove(n) == (xs.erase(n) == 1));
+      }
+      n = static_cast<int>(rng() % N);
+      assert(y.insert(n) == ys.insert(n).second);
+      checkFixed(x, xs);
+   }
+   checkFixed(y, ys);
+
+   FixedIntSet<N> result = x + y;
+   checkFixed(result, setUnion(xs, ys));
+   result = x * y;
+   checkFixed(result, setIntersection(xs, ys));
+   result = x - y;
+   checkFixed(result, setDifference(xs, ys));
+   result = x;
+   result += y;
+   result -= x;
+   checkFixed(result, setDifference(ys, xs));
+   result *= x;
+   checkFixed(result, set<int>());
+
+   FixedIntSet<N> same(x);
+   assert(same == x && !(same != x));
+   int last = N - 1;
+   if (same.isInSet(last)) same.remove(last);
+   else same.insert(last);
+   assert(same != x);
+}
+
+// --------------------------------------------------------------------------
+// testFixedIntSet
+// FixedIntSet for universes inside one word, exactly one word, and across
+// several words
+static void testFixedIntSet()
+{
+   cout << "Starting testFixedIntSet" << endl;
+
+   testFixedUniverse<1>(21);
+   testFixedUniverse<24>(22);
+   testFixedUniverse<64>(23);
+   testFixedUniverse<130>(24);
+   testFixedUniverse<1000>(25);
+
+   FixedIntSet<24> hours{ 9, 12, 17, 24, -3 };
+   checkFixed(hours, set<int>{ 9, 12, 17 });
+   assert(toString(FixedIntSet<24>()) == "{}");
+   checkFixed(FIXED_A - FIXED_B, set<int>{ 0, 63, 127, 128 });
+
+   cout << "Ending testFixedIntSet" << endl;
+}
+
+int main()
+{
+   testWordPacking();
+   testKernels();
+   testRankSelect();
+   testSparseIntSet();
+   testMoveAndGrowth();
+   testBatches();
+   testIterators();
+   testBinary();
+   testConcurrentIntSet();
+   testWorkerPool();
+   testParallel();
+   testExpressions();
+   testScanner();
+   testCounting();
+   testFixedIntSet();
+   cout << "Done!" << endl;
+   return 0;
+}
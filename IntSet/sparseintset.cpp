@@ -0,0 +1,685 @@
+// Created by: Tanvir Tatla
+
+#include "sparseintset.h"
+#include "bitkernels.h"
+#include "intscan.h"
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+const int INIT_SIZE = 5;
+
+// number of integers in one chunk, and words in a bitmap container
+const int CHUNK_BITS = 65536;
+const int BITMAP_WORDS = CHUNK_BITS / 64;
+
+// largest array container; at this size an array and a bitmap use the
+// same memory
+const int ARRAY_MAX = 4096;
+
+// largest run container (a run takes 4 bytes, a bitmap 8192)
+const int RUN_MAX = 2048;
+
+// number of integers >> scans before inserting them
+const int SCAN_BATCH = 1024;
+
+// --------------------------------------------------------------------------
+// findRun
+// Returns the index of the last run whose start is at or below v, or -1 if
+// every run starts above v. runs holds (start, length - 1) pairs
+static int findRun(const vector<uint16_t>& runs, uint16_t v)
+{
+   int low = 0;
+   int high = static_cast<int>(runs.size() / 2) - 1;
+   int found = -1;
+
+   while (low <= high) {
+      int mid = (low + high) / 2;
+      if (runs[2 * mid] <= v) {
+         found = mid;
+         low = mid + 1;
+      }
+      else high = mid - 1;
+   }
+
+   return found;
+}
+
+// --------------------------------------------------------------------------
+// setBitRange
+// Sets bits first through last (inclusive) of a bitmap
+static void setBitRange(uint64_t* words, int first, int last)
+{
+   int firstWord = first / 64;
+   int lastWord = last / 64;
+   uint64_t firstMask = ~uint64_t(0) << (first % 64);
+   uint64_t lastMask = ~uint64_t(0) >> (63 - last % 64);
+
+   if (firstWord == lastWord) {
+      words[firstWord] |= firstMask & lastMask;
+      return;
+   }
+
+   words[firstWord] |= firstMask;
+   for (int w = firstWord + 1; w < lastWord; w++) {
+      words[w] = ~uint64_t(0);
+   }
+   words[lastWord] |= lastMask;
+}
+
+// ---------------------------------------------------------------------------
+// Constructor
+// Default constructor for class SparseIntSet
+SparseIntSet::SparseIntSet(int a, int b, int c, int d, int e)
+{
+   count = 0;
+
+   // add parameters to set if non-negative
+   int numbers[] = { a, b, c, d, e };
+   for (int i = 0; i < INIT_SIZE; i++) {
+      insert(numbers[i]);
+   }
+}
+
+// --------------------------------------------------------------------------
+// findChunk
+// Returns index of the chunk with the given key or -1 if there is none
+int SparseIntSet::findChunk(int key) const
+{
+   int low = 0;
+   int high = static_cast<int>(chunks.size()) - 1;
+
+   while (low <= high) {
+      int mid = (low + high) / 2;
+      if (chunks[mid].key == key) return mid;
+      if (chunks[mid].key < key) low = mid + 1;
+      else high = mid - 1;
+   }
+
+   return -1;
+}
+
+// --------------------------------------------------------------------------
+// containerHas
+// Returns true if the container holds low
+bool SparseIntSet::containerHas(const Container& c, uint16_t low)
+{
+   switch (c.type) {
+   case ARRAY:
+      return binary_search(c.values.begin(), c.values.end(), low);
+   case BITMAP:
+      return (c.bits[low / 64] >> (low % 64)) & 1;
+   default: {
+      int run = findRun(c.values, low);
+      return run >= 0 && low <= c.values[2 * run] + c.values[2 * run + 1];
+   }
+   }
+}
+
+// --------------------------------------------------------------------------
+// containerAdd
+// Adds low to the container. Returns false if it was already there
+bool SparseIntSet::containerAdd(Container& c, uint16_t low)
+{
+   if (c.type == ARRAY) {
+      vector<uint16_t>::iterator pos =
+         lower_bound(c.values.begin(), c.values.end(), low);
+      if (pos != c.values.end() && *pos == low) return false;
+      c.values.insert(pos, low);
+      c.cardinality++;
+   }
+
+   else if (c.type == BITMAP) {
+      uint64_t bit = uint64_t(1) << (low % 64);
+      if (c.bits[low / 64] & bit) return false;
+      c.bits[low / 64] |= bit;
+      c.cardinality++;
+      return true;
+   }
+
+   else {
+      vector<uint16_t>& runs = c.values;
+      int run = findRun(runs, low);
+      if (run >= 0 && low <= runs[2 * run] + runs[2 * run + 1]) return false;
+
+      int runCount = static_cast<int>(runs.size() / 2);
+      bool extendsPrev = run >= 0 &&
+         runs[2 * run] + runs[2 * run + 1] + 1 == low;
+      bool joinsNext = run + 1 < runCount && runs[2 * (run + 1)] == low + 1;
+
+      if (extendsPrev && joinsNext) {
+         // low fills the gap between two runs; merge them
+         runs[2 * run + 1] += runs[2 * (run + 1) + 1] + 2;
+         runs.erase(runs.begin() + 2 * (run + 1), runs.begin() + 2 * (run + 2));
+      }
+      else if (extendsPrev) runs[2 * run + 1]++;
+      else if (joinsNext) {
+         runs[2 * (run + 1)]--;
+         runs[2 * (run + 1) + 1]++;
+      }
+      else {
+         uint16_t newRun[] = { low, 0 };
+         runs.insert(runs.begin() + 2 * (run + 1), newRun, newRun + 2);
+      }
+      c.cardinality++;
+   }
+
+   // re-pick the container once an array or run list gets too big
+   if ((c.type == ARRAY && c.cardinality > ARRAY_MAX) ||
+      (c.type == RUN && static_cast<int>(c.values.size() / 2) > RUN_MAX)) {
+      uint64_t words[BITMAP_WORDS];
+      toBitmap(c, words);
+      c = fromBitmap(c.key, words);
+   }
+
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// containerRemove
+// Removes low from the container. Returns false if it was not there
+bool SparseIntSet::containerRemove(Container& c, uint16_t low)
+{
+   if (c.type == ARRAY) {
+      vector<uint16_t>::iterator pos =
+         lower_bound(c.values.begin(), c.values.end(), low);
+      if (pos == c.values.end() || *pos != low) return false;
+      c.values.erase(pos);
+      c.cardinality--;
+      return true;
+   }
+
+   if (c.type == BITMAP) {
+      uint64_t bit = uint64_t(1) << (low % 64);
+      if (!(c.bits[low / 64] & bit)) return false;
+      c.bits[low / 64] &= ~bit;
+      c.cardinality--;
+   }
+
+   else {
+      vector<uint16_t>& runs = c.values;
+      int run = findRun(runs, low);
+      if (run < 0) return false;
+
+      int start = runs[2 * run];
+      int end = start + runs[2 * run + 1];
+      if (low > end) return false;
+
+      if (start == end)
+         runs.erase(runs.begin() + 2 * run, runs.begin() + 2 * (run + 1));
+      else if (low == start) {
+         runs[2 * run]++;
+         runs[2 * run + 1]--;
+      }
+      else if (low == end) runs[2 * run + 1]--;
+      else {
+         // split the run around low
+         runs[2 * run + 1] = static_cast<uint16_t>(low - start - 1);
+         uint16_t newRun[] = { static_cast<uint16_t>(low + 1),
+            static_cast<uint16_t>(end - low - 1) };
+         runs.insert(runs.begin() + 2 * (run + 1), newRun, newRun + 2);
+      }
+      c.cardinality--;
+   }
+
+   // re-pick the container once a bitmap gets small or a run list too big
+   if ((c.type == BITMAP && c.cardinality <= ARRAY_MAX) ||
+      (c.type == RUN && static_cast<int>(c.values.size() / 2) > RUN_MAX)) {
+      uint64_t words[BITMAP_WORDS];
+      toBitmap(c, words);
+      c = fromBitmap(c.key, words);
+   }
+
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// toBitmap
+// Writes the container's members into a BITMAP_WORDS word bitmap
+void SparseIntSet::toBitmap(const Container& c, uint64_t* words)
+{
+   if (c.type == BITMAP) {
+      copy(c.bits.begin(), c.bits.end(), words);
+      return;
+   }
+
+   fill(words, words + BITMAP_WORDS, 0);
+
+   if (c.type == ARRAY) {
+      for (size_t i = 0; i < c.values.size(); i++) {
+         words[c.values[i] / 64] |= uint64_t(1) << (c.values[i] % 64);
+      }
+   }
+   else {
+      for (size_t i = 0; i < c.values.size(); i += 2) {
+         setBitRange(words, c.values[i], c.values[i] + c.values[i + 1]);
+      }
+   }
+}
+
+// --------------------------------------------------------------------------
+// fromBitmap
+// Returns a container for the given chunk key holding the members of a
+// bitmap, using whichever of array, bitmap or run takes the least memory
+SparseIntSet::Container SparseIntSet::fromBitmap(int key,
+   const uint64_t* words)
+{
+   Container c;
+   c.key = key;
+   c.cardinality = static_cast<int>(popcountWords(words, BITMAP_WORDS));
+
+   // a run starts at every set bit whose lower neighbour is clear
+   int runCount = 0;
+   uint64_t carry = 0;
+   for (int w = 0; w < BITMAP_WORDS; w++) {
+      runCount += popcount64(words[w] & ~((words[w] << 1) | carry));
+      carry = words[w] >> 63;
+   }
+
+   int arrayBytes = (c.cardinality <= ARRAY_MAX) ? 2 * c.cardinality
+      : 2 * CHUNK_BITS;
+   int runBytes = 4 * runCount;
+   int bitmapBytes = 8 * BITMAP_WORDS;
+
+   if (arrayBytes <= runBytes && arrayBytes <= bitmapBytes) {
+      c.type = ARRAY;
+      c.values.reserve(c.cardinality);
+      for (int w = 0; w < BITMAP_WORDS; w++) {
+         for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            c.values.push_back(
+               static_cast<uint16_t>(w * 64 + lowestBit64(bits)));
+         }
+      }
+   }
+
+   else if (runBytes < bitmapBytes) {
+      c.type = RUN;
+      c.values.reserve(2 * runCount);
+      int start = -1;
+      for (int i = 0; i <= CHUNK_BITS; i++) {
+         bool set = i < CHUNK_BITS && ((words[i / 64] >> (i % 64)) & 1);
+         if (set && start < 0) start = i;
+         else if (!set && start >= 0) {
+            c.values.push_back(static_cast<uint16_t>(start));
+            c.values.push_back(static_cast<uint16_t>(i - 1 - start));
+            start = -1;
+         }
+      }
+   }
+
+   else {
+      c.type = BITMAP;
+      c.bits.assign(words, words + BITMAP_WORDS);
+   }
+
+   return c;
+}
+
+// --------------------------------------------------------------------------
+// combine
+// Returns the union, intersection or difference of two containers with the
+// same key. Result may be empty
+SparseIntSet::Container SparseIntSet::combine(const Container& a,
+   const Container& b, SetOp op)
+{
+   Container result;
+   result.key = a.key;
+
+   // two arrays: merge the sorted lists
+   if (a.type == ARRAY && b.type == ARRAY) {
+      result.type = ARRAY;
+      back_insert_iterator<vector<uint16_t> > out(result.values);
+      if (op == UNION)
+         set_union(a.values.begin(), a.values.end(),
+            b.values.begin(), b.values.end(), out);
+      else if (op == INTERSECTION)
+         set_intersection(a.values.begin(), a.values.end(),
+            b.values.begin(), b.values.end(), out);
+      else
+         set_difference(a.values.begin(), a.values.end(),
+            b.values.begin(), b.values.end(), out);
+      result.cardinality = static_cast<int>(result.values.size());
+
+      if (result.cardinality <= ARRAY_MAX) return result;
+      uint64_t words[BITMAP_WORDS];
+      toBitmap(result, words);
+      return fromBitmap(result.key, words);
+   }
+
+   // an array filtered by another container: keep the array's members that
+   // are (intersection) or are not (difference) in the other container
+   if ((op == INTERSECTION && (a.type == ARRAY || b.type == ARRAY)) ||
+      (op == DIFFERENCE && a.type == ARRAY)) {
+      const Container& list = (a.type == ARRAY) ? a : b;
+      const Container& other = (a.type == ARRAY) ? b : a;
+      bool keepIfIn = (op == INTERSECTION);
+
+      result.type = ARRAY;
+      for (size_t i = 0; i < list.values.size(); i++) {
+         if (containerHas(other, list.values[i]) == keepIfIn)
+            result.values.push_back(list.values[i]);
+      }
+      result.cardinality = static_cast<int>(result.values.size());
+      return result;
+   }
+
+   // anything else: expand both to bitmaps and combine a word at a time
+   uint64_t left[BITMAP_WORDS];
+   uint64_t right[BITMAP_WORDS];
+   toBitmap(a, left);
+   toBitmap(b, right);
+
+   if (op == UNION) orWords(left, left, right, BITMAP_WORDS);
+   else if (op == INTERSECTION) andWords(left, left, right, BITMAP_WORDS);
+   else andNotWords(left, left, right, BITMAP_WORDS);
+
+   return fromBitmap(a.key, left);
+}
+
+// --------------------------------------------------------------------------
+// sameMembers
+// Returns true if two containers hold the same members, whatever their types
+bool SparseIntSet::sameMembers(const Container& a, const Container& b)
+{
+   if (a.cardinality != b.cardinality) return false;
+
+   if (a.type == b.type) {
+      if (a.type == BITMAP) return a.bits == b.bits;
+      return a.values == b.values;
+   }
+
+   uint64_t left[BITMAP_WORDS];
+   uint64_t right[BITMAP_WORDS];
+   toBitmap(a, left);
+   toBitmap(b, right);
+   return equalWords(left, right, BITMAP_WORDS);
+}
+
+// --------------------------------------------------------------------------
+// apply
+// Returns the result of a set operation on two sets, combining chunks with
+// equal keys and copying chunks only one side has when op keeps them
+SparseIntSet SparseIntSet::apply(const SparseIntSet& left,
+   const SparseIntSet& right, SetOp op)
+{
+   SparseIntSet result;
+   size_t i = 0;
+   size_t j = 0;
+
+   while (i < left.chunks.size() || j < right.chunks.size()) {
+      bool leftOnly = j == right.chunks.size() ||
+         (i < left.chunks.size() && left.chunks[i].key < right.chunks[j].key);
+      bool rightOnly = !leftOnly && (i == left.chunks.size() ||
+         right.chunks[j].key < left.chunks[i].key);
+
+      if (leftOnly) {
+         if (op != INTERSECTION) result.chunks.push_back(left.chunks[i]);
+         i++;
+      }
+      else if (rightOnly) {
+         if (op == UNION) result.chunks.push_back(right.chunks[j]);
+         j++;
+      }
+      else {
+         Container c = combine(left.chunks[i], right.chunks[j], op);
+         if (c.cardinality > 0) result.chunks.push_back(c);
+         i++;
+         j++;
+      }
+   }
+
+   for (size_t k = 0; k < result.chunks.size(); k++) {
+      result.count += result.chunks[k].cardinality;
+   }
+
+   return result;
+}
+
+// --------------------------------------------------------------------------
+// insert
+// Return true if n is successfully inserted and false if unsuccessful
+bool SparseIntSet::insert(int n)
+{
+   if (n < 0) return false;
+
+   int key = n >> 16;
+   uint16_t low = static_cast<uint16_t>(n & 0xFFFF);
+
+   // find the chunk, creating an empty array chunk if there is none
+   int index = findChunk(key);
+   if (index < 0) {
+      Container c;
+      c.key = key;
+      c.type = ARRAY;
+      c.cardinality = 0;
+
+      vector<Container>::iterator pos = lower_bound(chunks.begin(),
+         chunks.end(), key,
+         [](const Container& chunk, int k) { return chunk.key < k; });
+      index = static_cast<int>(pos - chunks.begin());
+      chunks.insert(pos, c);
+   }
+
+   if (!containerAdd(chunks[index], low)) return false;
+
+   count++;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// remove
+// Return true if n is successfully removed and false if unsuccessful
+bool SparseIntSet::remove(int n)
+{
+   if (n < 0) return false;
+
+   int index = findChunk(n >> 16);
+   if (index < 0) return false;
+
+   if (!containerRemove(chunks[index], static_cast<uint16_t>(n & 0xFFFF)))
+      return false;
+
+   // drop chunks that become empty
+   if (chunks[index].cardinality == 0)
+      chunks.erase(chunks.begin() + index);
+
+   count--;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// isInSet
+// Return true if n is in the set or false if not in set
+bool SparseIntSet::isInSet(int n) const
+{
+   if (n < 0) return false;
+
+   int index = findChunk(n >> 16);
+   return index >= 0 &&
+      containerHas(chunks[index], static_cast<uint16_t>(n & 0xFFFF));
+}
+
+// --------------------------------------------------------------------------
+// isEmpty
+// Return true if count is 0 (set is empty) and false otherwise
+bool SparseIntSet::isEmpty() const
+{
+   return count == 0;
+}
+
+// --------------------------------------------------------------------------
+// size
+// Returns the number of integers in the set
+int SparseIntSet::size() const
+{
+   return count;
+}
+
+// --------------------------------------------------------------------------
+// optimize
+// Re-picks the smallest container (array, bitmap or run) for every chunk
+void SparseIntSet::optimize()
+{
+   uint64_t words[BITMAP_WORDS];
+   for (size_t i = 0; i < chunks.size(); i++) {
+      toBitmap(chunks[i], words);
+      chunks[i] = fromBitmap(chunks[i].key, words);
+   }
+}
+
+// --------------------------------------------------------------------------
+// memoryUsage
+// Returns approximate number of bytes held by the chunks and their containers
+long long SparseIntSet::memoryUsage() const
+{
+   long long bytes = static_cast<long long>(chunks.capacity()) *
+      sizeof(Container);
+
+   for (size_t i = 0; i < chunks.size(); i++) {
+      bytes += chunks[i].values.capacity() * sizeof(uint16_t);
+      bytes += chunks[i].bits.capacity() * sizeof(uint64_t);
+   }
+
+   return bytes;
+}
+
+// --------------------------------------------------------------------------
+// operator+
+// Returns union of two SparseIntSets
+SparseIntSet SparseIntSet::operator+(const SparseIntSet& set) const
+{
+   return apply(*this, set, UNION);
+}
+
+// --------------------------------------------------------------------------
+// operator*
+// Returns intersection of two SparseIntSets
+SparseIntSet SparseIntSet::operator*(const SparseIntSet& set) const
+{
+   return apply(*this, set, INTERSECTION);
+}
+
+// --------------------------------------------------------------------------
+// operator-
+// Returns difference of two SparseIntSets
+SparseIntSet SparseIntSet::operator-(const SparseIntSet& set) const
+{
+   return apply(*this, set, DIFFERENCE);
+}
+
+// --------------------------------------------------------------------------
+// operator+=
+// Unifies right and left operands and assigns result to left
+SparseIntSet& SparseIntSet::operator+=(const SparseIntSet& set)
+{
+   *this = apply(*this, set, UNION);
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// operator*=
+// Intersects right and left operands and assigns result to left
+SparseIntSet& SparseIntSet::operator*=(const SparseIntSet& set)
+{
+   *this = apply(*this, set, INTERSECTION);
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// operator-=
+// Subtracts the right operand from the left and assigns result to left
+SparseIntSet& SparseIntSet::operator-=(const SparseIntSet& set)
+{
+   *this = apply(*this, set, DIFFERENCE);
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// operator==
+// Returns true when two SparseIntSets have the same members, even if they
+// store them in different container types
+bool SparseIntSet::operator==(const SparseIntSet& set) const
+{
+   if (count != set.count || chunks.size() != set.chunks.size()) return false;
+
+   for (size_t i = 0; i < chunks.size(); i++) {
+      if (chunks[i].key != set.chunks[i].key ||
+         !sameMembers(chunks[i], set.chunks[i]))
+         return false;
+   }
+
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// operator!=
+// Returns true when two SparseIntSets are different. Otherwise returns false.
+bool SparseIntSet::operator!=(const SparseIntSet& set) const
+{
+   return !(*this == set);
+}
+
+// --------------------------------------------------------------------------
+// operator<<
+// Returns ostream of the set's integers, in the same format as IntSet:
+// each integer has a space before it and all are enclosed by curly brackets
+ostream& operator<<(ostream& output, const SparseIntSet& set)
+{
+   output << '{';
+
+   for (size_t i = 0; i < set.chunks.size(); i++) {
+      const SparseIntSet::Container& c = set.chunks[i];
+      int base = c.key << 16;
+
+      if (c.type == SparseIntSet::ARRAY) {
+         for (size_t j = 0; j < c.values.size(); j++) {
+            output << ' ' << base + c.values[j];
+         }
+      }
+      else if (c.type == SparseIntSet::BITMAP) {
+         for (int w = 0; w < BITMAP_WORDS; w++) {
+            for (uint64_t bits = c.bits[w]; bits != 0; bits &= bits - 1) {
+               output << ' ' << base + w * 64 + lowestBit64(bits);
+            }
+         }
+      }
+      else {
+         // step over the run's offsets, so a run ending at INT_MAX
+         // does not overflow
+         for (size_t j = 0; j < c.values.size(); j += 2) {
+            int first = base + c.values[j];
+            for (int offset = 0; offset <= c.values[j + 1]; offset++) {
+               output << ' ' << first + offset;
+            }
+         }
+      }
+   }
+
+   output << '}';
+
+   return output;
+}
+
+// --------------------------------------------------------------------------
+// operator>>
+// Returns istream. Reads one line (after skipping blank lines) and inserts
+// the integers on it, scanned the same way as IntSet's operator>>:
+// negative integers and non-integers are ignored. At the end of the input
+// nothing is read and the stream is left failed
+istream& operator>>(istream& input, SparseIntSet& set)
+{
+   string line;
+   input >> ws;
+   getline(input, line);
+
+   const char* start = line.data();
+   const char* p = start;
+   const char* end = start + line.size();
+   int values[SCAN_BATCH];
+   while (p < end) {
+      int n = scanInts(p, start, end, values, SCAN_BATCH);
+      for (int i = 0; i < n; i++) set.insert(values[i]);
+   }
+
+   return input;
+}
@@ -0,0 +1,119 @@
+// Created by: Tanvir Tatla
+
+#ifndef SPARSEINTSET_H
+#define SPARSEINTSET_H
+#include <cstdint>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// SparseIntSet class:  compressed version of IntSet for sets whose members
+// are spread over a huge range. Has the same operations as IntSet:
+//   -- unify, intersect, and return the difference of sets
+//   -- allows for the assignment and comparison of sets
+//   -- print sets
+//   -- insert and remove integers from a set
+//
+// Implementation and assumptions:
+//   -- members are split into chunks of 65536 integers by their high 16
+//      bits; only chunks holding at least one member are stored, sorted by
+//      chunk key
+//   -- each chunk stores its low 16 bits in one of three containers:
+//         array:  sorted list of members, used for up to 4096 members
+//         bitmap: 1024 words with one bit per integer in the chunk
+//         run:    list of (start, length - 1) pairs of consecutive members
+//   -- insert and remove keep array and bitmap containers within their
+//      size limits; set operators and optimize() pick whichever of the
+//      three containers is smallest for each result chunk
+//   -- operators work across any mix of container types
+//   -- constructor, <<, and >> behave the same as in IntSet
+//   -- copy, assignment and destruction are member-wise
+//---------------------------------------------------------------------------
+
+class SparseIntSet
+{
+   friend ostream& operator<<(ostream&, const SparseIntSet&);
+   friend istream& operator>>(istream&, SparseIntSet&);
+
+public:
+   // default constructor. If parameters are not set, then parameters will be
+   // set to -1
+   SparseIntSet(int = -1, int = -1, int = -1, int = -1, int = -1);
+
+   bool insert(int);
+   bool remove(int);
+
+   bool isInSet(int) const;
+   bool isEmpty() const;
+
+   // number of integers in the set
+   int size() const;
+
+   // re-pick the smallest container for every chunk
+   void optimize();
+
+   // approximate number of bytes held by the chunks and their containers
+   long long memoryUsage() const;
+
+   // mathematical operators
+   SparseIntSet operator+(const SparseIntSet &) const;
+   SparseIntSet operator*(const SparseIntSet &) const;
+   SparseIntSet operator-(const SparseIntSet &) const;
+
+   // more mathematical operators
+   SparseIntSet& operator+=(const SparseIntSet &);
+   SparseIntSet& operator*=(const SparseIntSet &);
+   SparseIntSet& operator-=(const SparseIntSet &);
+
+   // relational operators
+   bool operator==(const SparseIntSet &) const;
+   bool operator!=(const SparseIntSet &) const;
+
+private:
+   enum ContainerType { ARRAY, BITMAP, RUN };
+
+   // one chunk of 65536 integers
+   struct Container {
+      // high 16 bits shared by every member of the chunk
+      int key;
+
+      ContainerType type;
+
+      // number of members in the chunk
+      int cardinality;
+
+      // ARRAY: sorted low 16 bits of members
+      // RUN: start, length - 1 of each run, ordered by start
+      vector<uint16_t> values;
+
+      // BITMAP: one bit per integer of the chunk
+      vector<uint64_t> bits;
+   };
+
+   // operation applied to a pair of chunks
+   enum SetOp { UNION, INTERSECTION, DIFFERENCE };
+
+   // chunks sorted by key, none of them empty
+   vector<Container> chunks;
+
+   // count of numbers in set
+   int count;
+
+   // index of the chunk with the given key, or -1 if there is none
+   int findChunk(int) const;
+
+   // container helpers, all working on the low 16 bits of a member
+   static bool containerHas(const Container&, uint16_t);
+   static bool containerAdd(Container&, uint16_t);
+   static bool containerRemove(Container&, uint16_t);
+   static void toBitmap(const Container&, uint64_t*);
+   static Container fromBitmap(int, const uint64_t*);
+   static Container combine(const Container&, const Container&, SetOp);
+   static bool sameMembers(const Container&, const Container&);
+
+   // applies a set operation to all chunks of both sets
+   static SparseIntSet apply(const SparseIntSet&, const SparseIntSet&, SetOp);
+};
+
+#endif
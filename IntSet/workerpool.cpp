@@ -0,0 +1,126 @@
+// Created by: Tanvir Tatla
+
+#include "workerpool.h"
+
+// ---------------------------------------------------------------------------
+// Constructor
+// Creates a pool with no threads; they start on first use
+WorkerPool::WorkerPool()
+{
+   job = NULL;
+   jobTasks = 0;
+   helpers = 0;
+   generation = 0;
+   busy = 0;
+   stopping = false;
+   nextTask.store(0);
+}
+
+// ---------------------------------------------------------------------------
+// Destructor
+// Wakes every worker, tells it to stop, and waits for it
+WorkerPool::~WorkerPool()
+{
+   {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+   }
+   wake.notify_all();
+
+   for (thread& worker : workers) worker.join();
+}
+
+// --------------------------------------------------------------------------
+// shared
+// Returns the pool shared by all IntSets
+WorkerPool& WorkerPool::shared()
+{
+   static WorkerPool pool;
+   return pool;
+}
+
+// --------------------------------------------------------------------------
+// hardwareThreads
+// Returns the number of hardware threads, or 1 if it is not known
+int WorkerPool::hardwareThreads()
+{
+   int threads = static_cast<int>(thread::hardware_concurrency());
+   return (threads > 0) ? threads : 1;
+}
+
+// --------------------------------------------------------------------------
+// run
+// Runs task(i) for every i below tasks on up to threads threads, the
+// calling thread included, and returns when all of them are done. Runs
+// everything on the calling thread when one thread or one task is enough
+void WorkerPool::run(int tasks, int threads, const function<void(int)>& task)
+{
+   if (threads <= 0) threads = hardwareThreads();
+   if (threads > tasks) threads = tasks;
+
+   if (threads <= 1) {
+      for (int i = 0; i < tasks; i++) task(i);
+      return;
+   }
+
+   lock_guard<mutex> turn(runLock);
+   {
+      unique_lock<mutex> guard(lock);
+
+      // start any workers this run needs that do not exist yet
+      while (static_cast<int>(workers.size()) < threads - 1) {
+         workers.emplace_back(&WorkerPool::workerLoop, this,
+            static_cast<int>(workers.size()));
+      }
+
+      job = &task;
+      jobTasks = tasks;
+      helpers = threads - 1;
+      busy = helpers;
+      nextTask.store(0);
+      generation++;
+   }
+   wake.notify_all();
+
+   drain();
+
+   // wait for the helpers so task is not used after run returns
+   unique_lock<mutex> guard(lock);
+   done.wait(guard, [this] { return busy == 0; });
+   job = NULL;
+}
+
+// --------------------------------------------------------------------------
+// drain
+// Takes and runs tasks of the current run until none are left
+void WorkerPool::drain()
+{
+   for (int i = nextTask.fetch_add(1); i < jobTasks;
+      i = nextTask.fetch_add(1)) {
+      (*job)(i);
+   }
+}
+
+// --------------------------------------------------------------------------
+// workerLoop
+// Waits for a run that asks for this worker, helps with it, and repeats
+// until the pool is destroyed
+void WorkerPool::workerLoop(int index)
+{
+   long long seen = 0;
+   unique_lock<mutex> guard(lock);
+
+   while (true) {
+      wake.wait(guard, [&] {
+         return stopping || (generation != seen && index < helpers);
+      });
+      if (stopping) return;
+      seen = generation;
+
+      guard.unlock();
+      drain();
+      guard.lock();
+
+      if (--busy == 0) done.notify_one();
+   }
+}
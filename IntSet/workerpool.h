@@ -0,0 +1,86 @@
+// Created by: Tanvir Tatla
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------------
+// WorkerPool class:  fixed group of threads that run numbered tasks in
+// parallel. Used by IntSet's parallel set algebra to split a word range
+// into chunks.
+//
+// Implementation and assumptions:
+//   -- run(tasks, threads, task) calls task(0) .. task(tasks - 1), each
+//      exactly once, on up to threads threads, and returns when every call
+//      has finished. The calling thread is one of the threads
+//   -- tasks are handed out one at a time from an atomic counter, so a
+//      thread that finishes early takes the next chunk
+//   -- workers are started the first time they are needed and then sleep
+//      on a condition variable between runs
+//   -- one run at a time: callers of run on the same pool take turns
+//   -- task must not call run on the same pool
+//---------------------------------------------------------------------------
+
+class WorkerPool
+{
+public:
+   WorkerPool();
+   ~WorkerPool();
+
+   WorkerPool(const WorkerPool &) = delete;
+   WorkerPool& operator=(const WorkerPool &) = delete;
+
+   // runs task(i) for every i below tasks on up to threads threads
+   // (0 = one per hardware thread)
+   void run(int tasks, int threads, const function<void(int)> &task);
+
+   // pool shared by all IntSets
+   static WorkerPool& shared();
+
+   // number of hardware threads, at least 1
+   static int hardwareThreads();
+
+private:
+   // started worker threads
+   vector<thread> workers;
+
+   // serializes calls to run
+   mutex runLock;
+
+   // guards everything below; wake signals a new run or shutdown, done
+   // signals that the last helping worker finished
+   mutex lock;
+   condition_variable wake;
+   condition_variable done;
+
+   // current run: task, number of tasks, workers asked to help
+   const function<void(int)> *job;
+   int jobTasks;
+   int helpers;
+
+   // number of the current run, so a worker helps each run once
+   long long generation;
+
+   // helping workers that have not finished the current run
+   int busy;
+
+   // true when the pool is being destroyed
+   bool stopping;
+
+   // next task number to hand out
+   atomic<int> nextTask;
+
+   // body of worker number index
+   void workerLoop(int);
+
+   // takes and runs tasks of the current run until none are left
+   void drain();
+};
+
+#endif
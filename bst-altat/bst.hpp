@@ -7,21 +7,96 @@
 // Uses templates to store any type of Data
 // binarysearchtreee.cpp file is included at the bottom of the .h file
 // binarysearchtreee.cpp is part of the template, cannot be compiled separately
+//   -- every Node points to its Parent, so traversals, iterators, clear
+//      and comparison walk the tree with loops instead of recursion: a
+//      degenerate tree (e.g. from sorted adds) of any height cannot
+//      overflow the stack, and no traversal allocates memory
+//   -- every Node keeps its Height, so getHeight is O(1) and the balancing
+//      policy (second template parameter) can restore balance on the way
+//      back up from add and remove
+//   -- every Node keeps its Size (Nodes in its subtree), so size, rank,
+//      select and range counts take O(log n) on a balanced tree
+//   -- Nodes come from the allocator (third template parameter), by
+//      default a NodePool that carves them out of large blocks and frees
+//      them all at once
+//   -- rebalance() and ScapegoatBalance rebuild subtrees by relinking
+//      their Nodes in place, and time each rebuild into pauses()
 
 #ifndef BST_HPP
 #define BST_HPP
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bstsnapshot.hpp"
+#include "nodepool.hpp"
+#include "pausehistogram.hpp"
 
 using namespace std;
 
-template<class T>
+// balancing policies for the second template parameter of BST
+
+// plain BST: Items stay where add puts them, so sorted adds make a
+// degenerate tree and only rebalance() shortens it
+struct NoBalance {};
+
+// AVL tree: add and remove rotate Nodes so that the heights of the two
+// subtrees of every Node differ by at most 1, keeping the height below
+// 1.45 log2(n + 2) however the Items arrive
+struct AvlBalance {};
+
+// scapegoat-style partial rebuilding: add and remove keep every Node
+// weight balanced, neither subtree holding more than 2/3 of its Nodes;
+// the highest Node that breaks this (the scapegoat) has just its subtree
+// rebuilt perfectly balanced, so the height stays below 1.71 log2(n) and
+// add and remove take O(log n) amortized, with no rotations and no
+// stop-the-world rebalance()
+struct ScapegoatBalance {};
+
+// key types that contains compares with T directly even though they
+// convert to T, because the conversion costs more than the comparisons
+// (a string allocation); specialize for other such pairs
+template<class T, class K>
+struct IsTransparentKey : false_type {};
+
+template<>
+struct IsTransparentKey<string, const char*> : true_type {};
+
+template<>
+struct IsTransparentKey<string, char*> : true_type {};
+
+// true if K and T compare with < in both orders
+template<class T, class K, class = void>
+struct IsComparableKey : false_type {};
+
+template<class T, class K>
+struct IsComparableKey<T, K, decltype(void(declval<const K&>() <
+   declval<const T&>()), void(declval<const T&>() < declval<const K&>()))>
+   : true_type {};
+
+// true if contains looks K up without making a T: K compares with T, and
+// either does not convert to T (so the T version can not take it) or is
+// transparent. A K that converts, like double for BST<int>, is converted
+// first, the same as before there was a K version
+template<class T, class K>
+struct IsHeterogeneousKey : integral_constant<bool,
+   IsComparableKey<T, K>::value && (!is_convertible<const K&, T>::value ||
+   IsTransparentKey<T, typename decay<K>::type>::value)> {};
+
+template<class T, class Balance = NoBalance,
+   class Allocator = NodePool<T>>
 class BST {
    // display BST tree in a human-readable format
    friend ostream& operator<<(ostream& Out, const BST& Bst) {
@@ -37,19 +112,80 @@ private:
       T Data;
       struct Node* Left;
       struct Node* Right;
+      struct Node* Parent; // nullptr for Root
+      int Height; // 1 for a leaf
+      int Size; // Nodes in subtree, 1 for a leaf
+
+      // leaf Node below P, Data is constructed from Args
+      template<class... Args>
+      explicit Node(Node* P, Args&&... A)
+         : Data(forward<Args>(A)...), Left(nullptr), Right(nullptr),
+         Parent(P), Height(1), Size(1) {}
    };
 
    // refer to data type "struct Node" as Node
    using Node = struct Node;
 
+   // allocator for Nodes
+   using NodeAllocator =
+      typename allocator_traits<Allocator>::template rebind_alloc<Node>;
+   using NodeTraits = allocator_traits<NodeAllocator>;
+
+   // true for NodePool, which can free all Nodes at once
+   template<class A>
+   struct IsNodePool : false_type {};
+   template<class U>
+   struct IsNodePool<NodePool<U>> : true_type {};
+
    // root of the tree
    Node* Root{ nullptr };
 
+   // where Nodes come from
+   NodeAllocator Pool;
+
+   // how long each rebuild of a subtree took; not copied or moved with
+   // the Nodes
+   PauseHistogram Pauses;
+
+   // ScapegoatBalance rebuilds a subtree once a child holds more than
+   // HeavyNum / HeavyDen of its Nodes
+   static const int HeavyNum = 2;
+   static const int HeavyDen = 3;
+
+   // new leaf Node below Parent, its Data constructed from Args
+   template<class... Args>
+   Node* newNode(Node* Parent, Args&&... A) {
+      Node* N = NodeTraits::allocate(Pool, 1);
+      try {
+         NodeTraits::construct(Pool, N, Parent, forward<Args>(A)...);
+      }
+      catch (...) {
+         NodeTraits::deallocate(Pool, N, 1);
+         throw;
+      }
+      return N;
+   }
+
+   // destroy N and give its memory back to the allocator
+   void deleteNode(Node* N) {
+      NodeTraits::destroy(Pool, N);
+      NodeTraits::deallocate(Pool, N, 1);
+   }
+
    // height of a Node, nullptr is 0, Root is 1, static, no access to 'this'
    static int getHeight(const Node* N) {
-      if (N == nullptr) return 0;
+      return (N == nullptr ? 0 : N->Height);
+   }
+
+   // Nodes in subtree, nullptr is 0
+   static int getSize(const Node* N) {
+      return (N == nullptr ? 0 : N->Size);
+   }
 
-      return max(1 + getHeight(N->Left), 1 + getHeight(N->Right));
+   // recompute Height and Size of N from its children
+   static void update(Node* N) {
+      N->Height = 1 + max(getHeight(N->Left), getHeight(N->Right));
+      N->Size = 1 + getSize(N->Left) + getSize(N->Right);
    }
 
    /**
@@ -152,198 +288,488 @@ private:
    // helper function for converting an array to a balanced BST w/minimum 
    // height, works recursively
    // Start and End are Indices used to partition Array
-   static Node* arrayToBst(const T Arr[], int Start, int End) {
+   // recursion depth is only log2(End - Start)
+   Node* arrayToBst(const T Arr[], int Start, int End,
+      Node* Parent = nullptr) {
       // array can't be divided by 2 if Start > End
       if (Start > End) return nullptr;
 
       // Pick Middle Item as Root
       int Mid = (Start + End) / 2;
-      auto N = new Node;
-      setNode(Arr[Mid], N);
+      Node* N = newNode(Parent, Arr[Mid]);
 
       // Recurse on smaller array pieces
-      N->Left = arrayToBst(Arr, Start, Mid - 1);
-      N->Right = arrayToBst(Arr, Mid + 1, End);
+      N->Left = arrayToBst(Arr, Start, Mid - 1, N);
+      N->Right = arrayToBst(Arr, Mid + 1, End, N);
+      update(N);
 
       // return Root
       return N;
    }
 
-   // helper function for copy constructor, works recursively
-   void copy(Node* N) {
-      // nothing to copy if NULL
-      if (N != nullptr) {
-         // add copies using preorder traversal (root, left, right) so that
-         // structure is same
-         add(N->Data);
-         copy(N->Left);
-         copy(N->Right);
+   // helper function for copy constructor
+   // returns a copy of the tree under N with the same structure, built
+   // Node by Node in preorder (adding the Items again could rotate them
+   // into a different shape)
+   Node* copy(Node* N) {
+      if (N == nullptr) return nullptr; // nothing to copy if NULL
+
+      Node* Copy = newNode(nullptr, N->Data);
+      Copy->Height = N->Height;
+      Copy->Size = N->Size;
+
+      // Source and Target move together; a child of Source is visited
+      // once Target has no copy of it yet
+      Node* Source = N;
+      Node* Target = Copy;
+      while (true) {
+         if (Source->Left != nullptr && Target->Left == nullptr) {
+            Source = Source->Left;
+            Target->Left = newNode(Target, Source->Data);
+            Target = Target->Left;
+         }
+         else if (Source->Right != nullptr && Target->Right == nullptr) {
+            Source = Source->Right;
+            Target->Right = newNode(Target, Source->Data);
+            Target = Target->Right;
+         }
+         else if (Source == N) {
+            return Copy;
+         }
+         else {
+            Source = Source->Parent;
+            Target = Target->Parent;
+            continue;
+         }
+         Target->Height = Source->Height;
+         Target->Size = Source->Size;
       }
    }
 
-   // total number of Nodes in Binary Tree
-   // nullptr is 0, Root is 1
-   static int countNodes(Node* N) {
-      if (N == nullptr) return 0;
+   // leftmost Node in subtree (smallest Item), nullptr if N is nullptr
+   static Node* leftmost(Node* N) {
+      if (N == nullptr) return nullptr;
 
-      return 1 + countNodes(N->Left) + countNodes(N->Right);
+      while (N->Left != nullptr)
+         N = N->Left; // traverse left until leftmost Node found
+
+      return N;
    }
 
-   // helper function for adding an Item to a BST, works recursively
-   // returns true if successfully added, returns false otherwise
-   // does not add Item if duplicate exists
-   static bool addHelper(const T& Item, Node*& Current) {
-      // if there is no Node at current location
-      if (Current == nullptr) {
-         Current = new Node; // then create a new Node
-         setNode(Item, Current); // and set its Data
-         return true;
+   // rightmost Node in subtree (largest Item), nullptr if N is nullptr
+   static Node* rightmost(Node* N) {
+      if (N == nullptr) return nullptr;
+
+      while (N->Right != nullptr)
+         N = N->Right;
+
+      return N;
+   }
+
+   // Node after N in inorder (Left-Root-Right), nullptr after the last
+   static Node* nextInOrder(Node* N) {
+      // next is leftmost Node in right subtree, if there is one
+      if (N->Right != nullptr) return leftmost(N->Right);
+
+      // else climb until coming up from a left child
+      while (N->Parent != nullptr && N == N->Parent->Right)
+         N = N->Parent;
+
+      return N->Parent;
+   }
+
+   // Node before N in inorder, nullptr before the first
+   static Node* prevInOrder(Node* N) {
+      if (N->Left != nullptr) return rightmost(N->Left);
+
+      while (N->Parent != nullptr && N == N->Parent->Left)
+         N = N->Parent;
+
+      return N->Parent;
+   }
+
+   // Node after N in preorder (Root-Left-Right), nullptr after the last
+   static Node* nextPreOrder(Node* N) {
+      if (N->Left != nullptr) return N->Left;
+      if (N->Right != nullptr) return N->Right;
+
+      // climb until a Parent with an unvisited right subtree
+      while (N->Parent != nullptr) {
+         if (N == N->Parent->Left && N->Parent->Right != nullptr)
+            return N->Parent->Right;
+         N = N->Parent;
       }
 
-      // if Item to add is less than Current's Data, then recurse left
-      if (Item < Current->Data) return addHelper(Item, Current->Left);
+      return nullptr;
+   }
+
+   // first Node of subtree in postorder (Left-Right-Root): the leaf reached
+   // by going left whenever possible and right otherwise
+   static Node* firstPostOrder(Node* N) {
+      if (N == nullptr) return nullptr;
 
-      // if Item to add is greater than Current's Data, then recurse right
-      if (Item > Current->Data) return addHelper(Item, Current->Right);
+      while (N->Left != nullptr || N->Right != nullptr)
+         N = (N->Left != nullptr ? N->Left : N->Right);
 
-      return false; // return false if duplicate Item
+      return N;
    }
 
-   // helper function for removing an Item to a BST, works recursively
-   // returns true if removed successfully, returns false otherwise
-   static bool removeHelper(const T& Item, Node*& Current) {
-      // if there is no Node at current location
-      if (Current == nullptr) return false; // then BST does not contain Item
+   // Node after N in postorder, nullptr after the last
+   // only compares N with its Parent's children, so N may already be deleted
+   static Node* nextPostOrder(Node* N) {
+      Node* Parent = N->Parent;
+
+      // after a left subtree comes the Parent's right subtree, if any
+      if (Parent != nullptr && N == Parent->Left && Parent->Right != nullptr)
+         return firstPostOrder(Parent->Right);
 
-      // if Item to remove is less than Current's Data, then recurse left
-      if (Item < Current->Data) return removeHelper(Item, Current->Left);
+      return Parent;
+   }
 
-      // if Item to remove is greater than Current's Data, then recurse right
-      if (Item > Current->Data) return removeHelper(Item, Current->Right);
+   // the pointer that holds N: Root, or Left or Right of N's Parent
+   static Node*& linkTo(Node* N, Node*& Root) {
+      if (N->Parent == nullptr) return Root;
 
-      // Item has been found in Current Node
-      Node* Successor;
+      return (N == N->Parent->Left ? N->Parent->Left : N->Parent->Right);
+   }
 
-      // if Current has 1 child or 0 children
-      if (Current->Left == nullptr || Current->Right == nullptr) {
-         Successor = Current;
-         // if no left child, then set Current to right
-         // if no right child, then set Current to left
-         // if 0 children, then Current will be set to nullptr
-         Current = (Current->Left == nullptr ? Current->Right : Current->Left);
-         delete Successor; // delete Node that contains Item
-         return true;
+   /**
+    * rotate N's right child R up into N's place, returns R
+         N              R
+        / \            / \
+       a   R    =>    N   c
+          / \        / \
+         b   c      a   b
+    */
+   static Node* rotateLeft(Node* N, Node*& Root) {
+      Node* R = N->Right;
+      linkTo(N, Root) = R;
+      R->Parent = N->Parent;
+
+      N->Right = R->Left;
+      if (N->Right != nullptr) N->Right->Parent = N;
+      R->Left = N;
+      N->Parent = R;
+
+      update(N);
+      update(R);
+      return R;
+   }
+
+   // rotate N's left child L up into N's place, returns L
+   static Node* rotateRight(Node* N, Node*& Root) {
+      Node* L = N->Left;
+      linkTo(N, Root) = L;
+      L->Parent = N->Parent;
+
+      N->Left = L->Right;
+      if (N->Left != nullptr) N->Left->Parent = N;
+      L->Right = N;
+      N->Parent = L;
+
+      update(N);
+      update(L);
+      return L;
+   }
+
+   // balance for NoBalance: only keep Height up to date
+   static Node* balance(Node* N, Node*& /*Root*/, NoBalance /*Policy*/) {
+      update(N);
+      return N;
+   }
+
+   // balance for AvlBalance: if one subtree of N is 2 taller than the
+   // other, rotate the taller one up (twice if its taller half is on the
+   // inside), returns the Node now in N's place
+   static Node* balance(Node* N, Node*& Root, AvlBalance /*Policy*/) {
+      update(N);
+      int Skew = getHeight(N->Right) - getHeight(N->Left);
+
+      if (Skew > 1) {
+         if (getHeight(N->Right->Left) > getHeight(N->Right->Right))
+            rotateRight(N->Right, Root);
+         return rotateLeft(N, Root);
+      }
+
+      if (Skew < -1) {
+         if (getHeight(N->Left->Right) > getHeight(N->Left->Left))
+            rotateLeft(N->Left, Root);
+         return rotateRight(N, Root);
       }
 
-      // else if Current has 2 children, then find Successor (leftmost Node
-      // in right subtree)
-      Successor = findSuccessor(Current->Right);
-      // overwrite Item to be removed w/Successor's Data
-      Current->Data = Successor->Data; 
-      // remove Successor from right subtree
-      return removeHelper(Successor->Data, Current->Right);
+      return N;
+   }
+
+   // after a subtree under N changed, walk up to Root updating Heights and
+   // restoring balance as the policy requires
+   void fixUp(Node* N, Node*& Root) {
+      fixUp(N, Root, Balance());
+   }
+
+   // fixUp for policies that balance one Node at a time
+   template<class Policy>
+   static void fixUp(Node* N, Node*& Root, Policy /*Policy*/) {
+      while (N != nullptr)
+         N = balance(N, Root, Policy())->Parent;
+   }
+
+   // fixUp for ScapegoatBalance: only Sizes on the path changed, so only
+   // Nodes on it can be out of weight balance; rebuilding the highest one
+   // balances the whole tree again
+   void fixUp(Node* N, Node*& Root, ScapegoatBalance /*Policy*/) {
+      Node* Scapegoat = nullptr;
+      for (; N != nullptr; N = N->Parent) {
+         update(N);
+         if (isHeavy(N)) Scapegoat = N;
+      }
+      if (Scapegoat == nullptr) return;
+
+      // the rebuilt subtree is shorter, so the Heights above it change
+      Node* Above = Scapegoat->Parent;
+      rebuild(Scapegoat, Root);
+      for (; Above != nullptr; Above = Above->Parent)
+         update(Above);
    }
 
-   // helper function that finds Successor in removeHelper
-   // returns the leftmost Node in subtree
-   static Node* findSuccessor(Node* N) {
-      Node* Current = N; 
+   // true if a child of N holds more than HeavyNum / HeavyDen of its Nodes
+   static bool isHeavy(const Node* N) {
+      return HeavyDen * max(getSize(N->Left), getSize(N->Right)) >
+         HeavyNum * N->Size;
+   }
 
-      while (Current != nullptr && Current->Left != nullptr)
-         Current = Current->Left; // traverse left until leftmost Node found
+   // rebuild the subtree at N perfectly balanced, in the shape arrayToBst
+   // gives, by relinking its own Nodes: no Item is copied or moved and
+   // nothing is allocated; O(Size of N), timed into Pauses
+   void rebuild(Node* N, Node*& Root) {
+      auto Start = chrono::steady_clock::now();
+      Node*& Link = linkTo(N, Root);
+      Node* Parent = N->Parent;
+      int Count = N->Size;
+
+      // chain the Nodes in ascending order through Right, from the largest
+      // down (prevInOrder does not read Right of the Nodes already chained)
+      Node* List = nullptr;
+      Node* Current = rightmost(N);
+      for (int I = 0; I < Count; I++) {
+         Node* Previous = prevInOrder(Current);
+         Current->Right = List;
+         List = Current;
+         Current = Previous;
+      }
+
+      Link = chainToBst(List, Count);
+      Link->Parent = Parent;
+      Pauses.recordSince(Start);
+   }
+
+   // helper function for rebuild: the first Count Nodes of List (chained
+   // through Right) as a balanced tree, List moves past them
+   // recursion depth is only log2(Count)
+   static Node* chainToBst(Node*& List, int Count) {
+      if (Count == 0) return nullptr;
+
+      // middle Node as root, like arrayToBst
+      int LeftCount = (Count - 1) / 2;
+      Node* Left = chainToBst(List, LeftCount);
+      Node* N = List;
+      List = List->Right;
+
+      N->Left = Left;
+      if (Left != nullptr) Left->Parent = N;
+      N->Right = chainToBst(List, Count - 1 - LeftCount);
+      if (N->Right != nullptr) N->Right->Parent = N;
+      update(N);
+      return N;
+   }
+
+   // helper function for adding an Item to a BST
+   // returns true if successfully added, returns false otherwise
+   // does not add Item if duplicate exists
+   // Item is copied or moved into the new Node, depending on how it is
+   // passed
+   template<class U>
+   bool addHelper(U&& Item, Node*& Root) {
+      Node* Parent = nullptr;
+      Node** Current = findLink(Item, Root, Parent);
+      if (Current == nullptr) return false; // return false if duplicate Item
+
+      *Current = newNode(Parent, forward<U>(Item)); // then create a new Node
+      fixUp(Parent, Root);
+      return true;
+   }
+
+   // where a Node holding Item belongs: returns the pointer to set, and
+   // sets Parent to the Node above it; returns nullptr if duplicate Item
+   static Node** findLink(const T& Item, Node*& Root, Node*& Parent) {
+      Node** Current = &Root;
+
+      // go left if Item to add is less than Current's Data, right if it is
+      // greater, until there is no Node at current location
+      while (*Current != nullptr) {
+         Parent = *Current;
+         if (Item < Parent->Data) Current = &Parent->Left;
+         else if (Item > Parent->Data) Current = &Parent->Right;
+         else return nullptr;
+      }
 
       return Current;
    }
 
-   // helper function for checking whether BST contains certain Item
-   // return true if BST contains item, returns false otherwise
-   static bool containsHelper(const T& Item, Node* Current) {
-      // if no Node at current location, then BST does not contain Item
-      if (Current == nullptr) return false;
+   // helper function for removing an Item to a BST
+   // returns true if removed successfully, returns false otherwise
+   bool removeHelper(const T& Item, Node*& Root) {
+      Node* Current = findNode(Item, Root);
+      if (Current == nullptr) return false; // BST does not contain Item
+
+      // if Current has 2 children, then find Successor (leftmost Node
+      // in right subtree), overwrite Item to be removed w/Successor's Data
+      // and remove Successor instead, which has no left child
+      if (Current->Left != nullptr && Current->Right != nullptr) {
+         Node* Successor = leftmost(Current->Right);
+         Current->Data = move(Successor->Data); // Successor is deleted
+         Current = Successor;
+      }
+
+      // Current has 1 child or 0 children: replace it by its child
+      // (nullptr if 0 children)
+      Node* Child = (Current->Left == nullptr ? Current->Right : Current->Left);
+      if (Child != nullptr) Child->Parent = Current->Parent;
+      linkTo(Current, Root) = Child;
+      fixUp(Current->Parent, Root);
+
+      deleteNode(Current); // delete Node that contains Item
+      return true;
+   }
+
+   // Node holding Item, nullptr if BST does not contain Item
+   // Item can be any type that compares with T by <, in both orders
+   template<class K>
+   static Node* findNode(const K& Item, Node* Current) {
+      while (Current != nullptr) {
+         // if Item is less than Current's Data, then go left
+         if (Item < Current->Data) Current = Current->Left;
+         // if Item is greater than Current's Data, then go right
+         else if (Current->Data < Item) Current = Current->Right;
+         else return Current; // Item found
+      }
+
+      return nullptr;
+   }
+
+   // Node holding the smallest Item not less than Item, nullptr if none
+   static Node* lowerBoundNode(const T& Item, Node* Current) {
+      Node* Lower = nullptr;
+      while (Current != nullptr) {
+         // Current is a candidate; anything smaller is to its left
+         if (!(Current->Data < Item)) {
+            Lower = Current;
+            Current = Current->Left;
+         }
+         else Current = Current->Right;
+      }
 
-      if (Current->Data == Item) return true; // Item found
+      return Lower;
+   }
 
-      // if Item is less than Current's Data, then recurse left
-      if (Item < Current->Data) return containsHelper(Item, Current->Left);
+   // number of Items less than Item, or not greater than Item if
+   // CountEqual is true
+   static int countBelow(const T& Item, Node* Current, bool CountEqual) {
+      int Count = 0;
+      while (Current != nullptr) {
+         if (Item < Current->Data) {
+            Current = Current->Left;
+         }
+         else if (Item > Current->Data) {
+            // Current and its left subtree are all less than Item
+            Count += getSize(Current->Left) + 1;
+            Current = Current->Right;
+         }
+         else {
+            return Count + getSize(Current->Left) + (CountEqual ? 1 : 0);
+         }
+      }
 
-      // if Item is greater than Current's Data, then recurse right
-      if (Item > Current->Data) return containsHelper(Item, Current->Right);
+      return Count;
+   }
 
-      return false;
+   // helper function for checking whether BST contains certain Item
+   // return true if BST contains item, returns false otherwise
+   template<class K>
+   static bool containsHelper(const K& Item, Node* Current) {
+      return findNode(Item, Current) != nullptr;
    }
 
    // helper function for inOrderTraverse (Left-Root-Right)
    // takes a function that takes a single parameter of type T
    static void inHelper(void Visit(const T& Item), Node* Current) {
-      if (Current == nullptr) return; // base case
-
-      inHelper(Visit, Current->Left); // traverse Left
-      Visit(Current->Data); // visit Root
-      inHelper(Visit, Current->Right); // traverse Right
+      for (Node* N = leftmost(Current); N != nullptr; N = nextInOrder(N))
+         Visit(N->Data);
    }
 
    // helper function for preOrderTraverse (Root-Left-Right)
    static void preHelper(void Visit(const T& Item), Node* Current) {
-      if (Current == nullptr) return;
-
-      Visit(Current->Data);
-      preHelper(Visit, Current->Left);
-      preHelper(Visit, Current->Right);
+      for (Node* N = Current; N != nullptr; N = nextPreOrder(N))
+         Visit(N->Data);
    }
 
    // helper function for postOrderTraverse (Left-Right-Root)
    static void postHelper(void Visit(const T& Item), Node* Current) {
-      if (Current == nullptr) return;
-
-      postHelper(Visit, Current->Left);
-      postHelper(Visit, Current->Right);
-      Visit(Current->Data);
+      for (Node* N = firstPostOrder(Current); N != nullptr;
+         N = nextPostOrder(N))
+         Visit(N->Data);
    }
 
    // helper function for inserting Items from BST to Array in ascending order
    static void bstToArray(T Arr[], Node* N, int& Index) {
-      if (N == nullptr) return; // Nothing to add to Array
-
       // use inorder traversal to add Items from BST to Array
-      bstToArray(Arr, N->Left, Index); // recurse left
-      Arr[Index++] = N->Data; // add Item to Array then increment Index
-      bstToArray(Arr, N->Right, Index); // recurse right
+      for (Node* Current = leftmost(N); Current != nullptr;
+         Current = nextInOrder(Current))
+         Arr[Index++] = Current->Data; // add Item, then increment Index
    }
 
    // helper function for emptying a BST
-   static void clearHelper(Node* Current) {
-      if (Current == nullptr) return; // nothing to clear
-
+   // any allocator: delete Node by Node
+   void clearHelper(Node* Current, false_type /*IsNodePool*/) {
       // use postorder traversal to delete children first and Root last
-      clearHelper(Current->Left); // recurse left, recurse right, visit Root
-      clearHelper(Current->Right);
+      Node* N = firstPostOrder(Current);
+      while (N != nullptr) {
+         Node* Next = nextPostOrder(N);
+         deleteNode(N);
+         N = Next;
+      }
+   }
 
-      delete Current; // delete Root
-      Current = nullptr;
+   // NodePool: destroy the Items if they need it, then free all blocks at
+   // once; for Items like int no Node is visited
+   void clearHelper(Node* Current, true_type /*IsNodePool*/) {
+      if (!is_trivially_destructible<Node>::value) {
+         Node* N = firstPostOrder(Current);
+         while (N != nullptr) {
+            Node* Next = nextPostOrder(N);
+            NodeTraits::destroy(Pool, N);
+            N = Next;
+         }
+      }
+      Pool.release();
    }
 
    // helper function for checking for equality
    // returns true if equal, returns false if inequal
+   // walks both trees in preorder side by side: while every pair of Nodes
+   // so far has equal Data and the same children, both walks take the same
+   // steps
    static bool isEqual(Node* Lhs, Node* Rhs) {
-      // End of subtree reached. Nothing left to check so return true.
-      if (Lhs == nullptr && Rhs == nullptr) return true;
-
-      // if both Nodes exist, then compare their Data for equality AND
-      // recurse Left AND recurse Right (check left and right subtrees for
-      // equality)
-      if (Lhs != nullptr && Rhs != nullptr) {
-         return (Lhs->Data == Rhs->Data && isEqual(Lhs->Left, Rhs->Left)
-            && isEqual(Lhs->Right, Rhs->Right));
+      while (Lhs != nullptr && Rhs != nullptr) {
+         if (!(Lhs->Data == Rhs->Data) ||
+            (Lhs->Left == nullptr) != (Rhs->Left == nullptr) ||
+            (Lhs->Right == nullptr) != (Rhs->Right == nullptr))
+            return false;
+         Lhs = nextPreOrder(Lhs);
+         Rhs = nextPreOrder(Rhs);
       }
 
-      return false; // One Node is nullptr and the other isn't so inequal
-   }
-
-   // setter for Node
-   static void setNode(const T Item, Node*& N) {
-      N->Data = Item; // set Data
-      N->Left = nullptr; // Left and Right are set to nullptr
-      N->Right = nullptr;
+      // equal only if both walks ended (or both trees were empty)
+      return Lhs == nullptr && Rhs == nullptr;
    }
 
    // checks if an Array is sorted
@@ -359,13 +785,73 @@ private:
    }
 
 public:
+   // bidirectional iterator over the Items in ascending order
+   // Items can't be changed through it, since that could break the order
+   // end() is one past the largest Item; --end() is the largest Item
+   class const_iterator {
+   public:
+      using iterator_category = bidirectional_iterator_tag;
+      using value_type = T;
+      using difference_type = ptrdiff_t;
+      using pointer = const T*;
+      using reference = const T&;
+
+      const_iterator() = default;
+
+      reference operator*() const { return Current->Data; }
+      pointer operator->() const { return &Current->Data; }
+
+      const_iterator& operator++() {
+         Current = nextInOrder(Current);
+         return *this;
+      }
+
+      const_iterator operator++(int) {
+         const_iterator Old = *this;
+         ++*this;
+         return Old;
+      }
+
+      const_iterator& operator--() {
+         Current = (Current == nullptr ? rightmost(Tree->Root)
+            : prevInOrder(Current));
+         return *this;
+      }
+
+      const_iterator operator--(int) {
+         const_iterator Old = *this;
+         --*this;
+         return Old;
+      }
+
+      bool operator==(const const_iterator& Other) const {
+         return Current == Other.Current;
+      }
+
+      bool operator!=(const const_iterator& Other) const {
+         return !(*this == Other);
+      }
+
+   private:
+      friend class BST;
+
+      const_iterator(Node* N, const BST* Bst) : Current(N), Tree(Bst) {}
+
+      // Node of the Item, nullptr for end()
+      Node* Current{ nullptr };
+      // tree iterated, so that --end() can find the largest Item
+      const BST* Tree{ nullptr };
+   };
+
+   // Items can only be read through iterators
+   using iterator = const_iterator;
+
    // constructor, empty tree
    BST() = default;
 
    // constructor, tree with root
    explicit BST(const T& RootItem) {
-      Root = new Node;
-      setNode(RootItem, Root);
+      Root = newNode(nullptr, RootItem);
    }
 
    // given an array of length n
@@ -389,10 +875,41 @@ public:
       else Root = arrayToBst(Arr, 0, N - 1);
    }
 
-   // copy constructor
-   BST(const BST<T>& Bst) {
-      Root = nullptr;
-      copy(Bst.Root);
+   // copy constructor, same structure as Bst
+   BST(const BST& Bst)
+      : Pool(NodeTraits::select_on_container_copy_construction(Bst.Pool)) {
+      Root = copy(Bst.Root);
+   }
+
+   // move constructor, takes Bst's Nodes, Bst becomes empty
+   BST(BST&& Bst) noexcept : Root(Bst.Root), Pool(move(Bst.Pool)) {
+      Bst.Root = nullptr;
+   }
+
+   // move assignment, frees this tree and takes Bst's Nodes (and, with a
+   // NodePool, the blocks holding them), Bst becomes empty
+   BST& operator=(BST&& Bst) noexcept {
+      static_assert(
+         NodeTraits::propagate_on_container_move_assignment::value,
+         "BST move assignment needs an allocator that moves with its Nodes");
+
+      if (this != &Bst) {
+         clear();
+         Pool = move(Bst.Pool);
+         Root = Bst.Root;
+         Bst.Root = nullptr;
+      }
+      return *this;
+   }
+
+   // assignment, same structure as Bst, O(n)
+   BST& operator=(const BST& Bst) {
+      // nothing to do when assigning to self
+      if (this != &Bst) {
+         clear();
+         Root = copy(Bst.Root);
+      }
+      return *this;
    }
 
    // destructor
@@ -413,7 +930,61 @@ public:
 
    // Number of nodes in BST
    int numberOfNodes() const {
-      return countNodes(Root);
+      return size();
+   }
+
+   // Number of Items in BST, O(1)
+   int size() const {
+      return getSize(Root);
+   }
+
+   // number of Items less than Item (its index if it is in BST)
+   int rank(const T& Item) const {
+      return countBelow(Item, Root, false);
+   }
+
+   // the K-th smallest Item, from K = 0, into Item
+   // returns false and leaves Item unchanged if K is not below size()
+   bool select(int K, T& Item) const {
+      if (K < 0 || K >= size()) return false;
+
+      Node* Current = Root;
+      while (true) {
+         int LeftSize = getSize(Current->Left);
+         if (K < LeftSize) {
+            Current = Current->Left;
+         }
+         else if (K > LeftSize) {
+            K -= LeftSize + 1; // skip left subtree and Current
+            Current = Current->Right;
+         }
+         else {
+            Item = Current->Data;
+            return true;
+         }
+      }
+   }
+
+   // number of Items from Lo to Hi, both included, 0 if Hi < Lo
+   int countInRange(const T& Lo, const T& Hi) const {
+      if (Hi < Lo) return 0;
+
+      return countBelow(Hi, Root, true) - countBelow(Lo, Root, false);
+   }
+
+   // call Visit(Item) for every Item from Lo to Hi (both included) in
+   // ascending order; Visit is a function or function object
+   template<class Visit>
+   void rangeVisit(const T& Lo, const T& Hi, Visit visit) const {
+      for (Node* N = lowerBoundNode(Lo, Root); N != nullptr && !(Hi < N->Data);
+         N = nextInOrder(N))
+         visit(N->Data);
+   }
+
+   // rangeVisit for a function like the traversals take, so that an
+   // overloaded function can be passed
+   void rangeVisit(const T& Lo, const T& Hi, void Visit(const T& Item)) const {
+      rangeVisit<void (*)(const T&)>(Lo, Hi, Visit);
    }
 
    // add a new item, return true if successful
@@ -421,6 +992,30 @@ public:
       return addHelper(Item, Root);
    }
 
+   // add a new item by moving it into the tree, return true if successful
+   // Item is left unchanged if it is a duplicate
+   bool add(T&& Item) {
+      return addHelper(move(Item), Root);
+   }
+
+   // add an item constructed in place from Args, return true if
+   // successful; the item is built first, then dropped if a duplicate
+   template<class... Args>
+   bool emplace(Args&&... A) {
+      Node* N = newNode(nullptr, forward<Args>(A)...);
+      Node* Parent = nullptr;
+      Node** Current = findLink(N->Data, Root, Parent);
+      if (Current == nullptr) {
+         deleteNode(N);
+         return false;
+      }
+
+      N->Parent = Parent;
+      *Current = N;
+      fixUp(Parent, Root);
+      return true;
+   }
+
    // remove item, return true if successful
    bool remove(const T& Item) {
       return removeHelper(Item, Root);
@@ -431,6 +1026,17 @@ public:
       return containsHelper(Item, Root);
    }
 
+   // true if an item equal to Key is in BST, without making a T from Key
+   // Key is any type that compares with T by <, in both orders, and
+   // either does not convert to T or is transparent (see
+   // IsHeterogeneousKey), e.g. const char* for BST<string>; every other
+   // Key goes to contains(const T&)
+   template<class K, class = typename enable_if<
+      IsHeterogeneousKey<T, K>::value>::type>
+   bool contains(const K& Key) const {
+      return containsHelper(Key, Root);
+   }
+
    // inorder traversal: left-root-right
    // takes a function that takes a single parameter of type T
    void inOrderTraverse(void Visit(const T& Item)) const {
@@ -447,39 +1053,97 @@ public:
       postHelper(Visit, Root);
    }
 
-   // create dynamic array, copy all the items to the array
-   // and then read the array to re-create this tree from scratch
-   // so that resulting tree is balanced
+   // iterator at the smallest Item, end() if empty
+   const_iterator begin() const {
+      return const_iterator(leftmost(Root), this);
+   }
+
+   // iterator one past the largest Item
+   const_iterator end() const {
+      return const_iterator(nullptr, this);
+   }
+
+   // re-create this tree with the minimum height, in the shape the array
+   // constructor gives, by relinking its Nodes in O(n) without copying
+   // Items or allocating; the pause is recorded in pauses()
    void rebalance() {
-      int Size = numberOfNodes(); // count Nodes in BST
-      auto Arr = new T[Size]; // create Array big enough to fit all Items
+      if (Root != nullptr) rebuild(Root, Root);
+   }
 
+   // how long each rebalance() and each rebuild by ScapegoatBalance took
+   const PauseHistogram& pauses() const {
+      return Pauses;
+   }
+
+   // read-only copy of the Items, laid out for fast lookups (see
+   // bstsnapshot.hpp); later changes to the tree do not change it
+   BSTSnapshot<T> snapshot() const {
+      vector<T> Sorted(numberOfNodes());
       int Index = 0;
-      bstToArray(Arr, Root, Index); // add Items from BST to Array
+      bstToArray(Sorted.data(), Root, Index); // add Items from BST to Array
+      return BSTSnapshot<T>(Sorted.data(), Index);
+   }
 
-      this->clear(); // empty 'this'
-      Root = arrayToBst(Arr, 0, Size - 1); // convert Array to balanced BST
-      delete[] Arr;
+   // replace the Items with those from First to Last, which must be in
+   // ascending order (repeated Items are kept once), in O(n)
+   // the tree is balanced like the array constructor builds it
+   // returns false and leaves the tree unchanged if the Items are not
+   // in order
+   template<class InputIt>
+   bool buildFromSorted(InputIt First, InputIt Last) {
+      vector<T> Sorted;
+      for (; First != Last; ++First) {
+         if (!Sorted.empty()) {
+            if (*First < Sorted.back()) return false; // unsorted Item found
+            if (!(Sorted.back() < *First)) continue; // repeated Item
+         }
+         Sorted.push_back(*First);
+      }
+
+      clear();
+      Root = arrayToBst(Sorted.data(), 0, static_cast<int>(Sorted.size()) - 1);
+      return true;
+   }
+
+   // add every Item of Other, in O(n + m): both trees are flattened in
+   // order, merged, and this tree is rebuilt balanced from the result
+   void merge(const BST& Other) {
+      if (this == &Other || Other.isEmpty()) return;
+
+      vector<T> Mine(size());
+      vector<T> Theirs(Other.size());
+      int Index = 0;
+      bstToArray(Mine.data(), Root, Index);
+      Index = 0;
+      bstToArray(Theirs.data(), Other.Root, Index);
+
+      vector<T> Merged;
+      Merged.reserve(Mine.size() + Theirs.size());
+      set_union(Mine.begin(), Mine.end(), Theirs.begin(), Theirs.end(),
+         back_inserter(Merged));
+
+      clear();
+      Root = arrayToBst(Merged.data(), 0, static_cast<int>(Merged.size()) - 1);
    }
 
    // delete all nodes in tree
    void clear() {
-      clearHelper(Root);
+      clearHelper(Root, IsNodePool<NodeAllocator>());
       Root = nullptr;
    }
 
    // trees are equal if they have the same structure
    // AND the same item values at all the nodes
-   bool operator==(const BST<T>& Other) const {
+   bool operator==(const BST& Other) const {
       // check if 'this' and Other are same reference
       if (this == &Other) return true; 
       return isEqual(Root, Other.Root);
    }
 
    // not == to each other
-   bool operator!=(const BST<T>& Other) const {
+   bool operator!=(const BST& Other) const {
       return !(*this == Other);
    }
 };
 
-#endif  
\ No newline at end of file
+#endif  
\ No newline at end of file
@@ -0,0 +1,490 @@
+/**
+ * Benchmarks for BST
+ *
+ *   -- builds a balanced tree of the given number of Nodes (default 10M)
+ *      with the array constructor, then times inorder, preorder and
+ *      postorder traversal, iteration with begin()/end(), numberOfNodes,
+ *      getHeight and clear
+ *   -- times the same traversals on a degenerate tree made by sorted adds
+ *   -- adds nearly sorted keys to a plain BST that calls rebalance() every
+ *      1000 adds, to an AVL tree and to a ScapegoatBalance tree, then times
+ *      lookups in all three and prints the rebuild pauses
+ *   -- prints the pauses of one rebalance() of a tree of random keys, and
+ *      of the rebuilds of a ScapegoatBalance tree while adding the same
+ *      keys and removing half of them
+ *   -- compares Nodes from NodePool and from std::allocator: building the
+ *      balanced tree, traversing it and clearing it, then adding random
+ *      keys to an AVL tree and clearing that
+ *   -- times 1M random lookups in the balanced tree, in its snapshot and
+ *      with std::lower_bound on the sorted array
+ *   -- times 1M countInRange, rank and select queries on that tree, and
+ *      counting ranges of about 1000 Items with rangeVisit
+ *   -- times buildFromSorted, the copy constructor and assignment on the
+ *      given number of Nodes, and merging two trees of half as many
+ *   -- counts heap allocations while adding 1M long strings by copy and by
+ *      move, and while looking them up by string and by const char*
+ *   -- measures lookups per second in a tree of 1M Items from 1, 2, 4, ...
+ *      reader threads (up to the given number, default one per core) while
+ *      one writer adds and removes Items, for ConcurrentBST and for an AVL
+ *      BST behind a mutex
+ *
+ * Usage: bstbench [nodes [threads]]
+ * @author Tanvir Tatla
+ */
+
+#include "bst.hpp"
+#include "concurrentbst.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// heap allocations made through operator new, from any thread
+static atomic<long long> Allocations(0);
+
+// the counting operators must not be inlined into library code, or GCC
+// sees malloc'd memory passed to operator delete and warns
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void* operator new(size_t Bytes) {
+   Allocations++;
+   void* P = malloc(Bytes != 0 ? Bytes : 1);
+   if (P == nullptr) throw bad_alloc();
+   return P;
+}
+
+NOINLINE void operator delete(void* P) noexcept {
+   free(P);
+}
+
+NOINLINE void operator delete(void* P, size_t /*Bytes*/) noexcept {
+   free(P);
+}
+
+// keeps results alive so the optimizer can not drop the timed work
+static volatile long long Sink = 0;
+
+// visitor for traversals, adds every Item to Sink
+static void sumVisitor(const int& Item) {
+   Sink = Sink + Item;
+}
+
+// seconds since Start
+static double secondsSince(chrono::steady_clock::time_point Start) {
+   return chrono::duration<double>(chrono::steady_clock::now() - Start)
+      .count();
+}
+
+// runs Op once and prints its time in milliseconds and nanoseconds per Node
+template<class Op>
+static void timeOnce(const char* Name, long long Nodes, Op op) {
+   auto Start = chrono::steady_clock::now();
+   op();
+   double Seconds = secondsSince(Start);
+   cout << left << setw(28) << Name << right << fixed << setprecision(1)
+      << setw(10) << Seconds * 1e3 << " ms" << setprecision(2) << setw(10)
+      << Seconds * 1e9 / Nodes << " ns/node" << endl;
+}
+
+// runs Op once and prints its time and heap allocations per call
+template<class Op>
+static void countAllocations(const char* Name, long long Calls, Op op) {
+   long long Start = Allocations;
+   auto StartTime = chrono::steady_clock::now();
+   op();
+   double Seconds = secondsSince(StartTime);
+   cout << left << setw(28) << Name << right << fixed << setprecision(1)
+      << setw(10) << Seconds * 1e3 << " ms" << setprecision(2) << setw(10)
+      << static_cast<double>(Allocations - Start) / Calls << " allocs/call"
+      << endl;
+}
+
+// prints how many pauses there were, the 50th, 99th and 99.9th
+// percentiles, the longest and their total time
+static void printPauses(const char* Name, const PauseHistogram& Pauses) {
+   cout << left << setw(28) << Name << right << setw(8) << Pauses.count()
+      << " pauses, us: p50 " << Pauses.percentile(50) / 1000
+      << " p99 " << Pauses.percentile(99) / 1000
+      << " p99.9 " << Pauses.percentile(99.9) / 1000
+      << " max " << Pauses.longest() / 1000
+      << " total " << Pauses.total() / 1000 << endl;
+}
+
+// times every traversal of Tree, which holds Nodes Items
+static void timeTraversals(BST<int>& Tree, long long Nodes) {
+   timeOnce("inOrderTraverse", Nodes,
+      [&] { Tree.inOrderTraverse(sumVisitor); });
+   timeOnce("preOrderTraverse", Nodes,
+      [&] { Tree.preOrderTraverse(sumVisitor); });
+   timeOnce("postOrderTraverse", Nodes,
+      [&] { Tree.postOrderTraverse(sumVisitor); });
+   timeOnce("begin() .. end()", Nodes, [&] {
+      long long Sum = 0;
+      for (int I : Tree)
+         Sum += I;
+      Sink = Sink + Sum;
+   });
+   timeOnce("numberOfNodes", Nodes,
+      [&] { Sink = Sink + Tree.numberOfNodes(); });
+   timeOnce("getHeight", Nodes, [&] { Sink = Sink + Tree.getHeight(); });
+   timeOnce("clear", Nodes, [&] { Tree.clear(); });
+}
+
+// builds, walks and clears trees whose Nodes come from Allocator
+template<class Allocator>
+static void timeAllocator(const vector<int>& Sorted,
+   const vector<int>& Random) {
+   auto Nodes = static_cast<long long>(Sorted.size());
+   {
+      unique_ptr<BST<int, NoBalance, Allocator>> Tree;
+      timeOnce("build from array", Nodes, [&] {
+         Tree.reset(new BST<int, NoBalance, Allocator>(Sorted.data(),
+            static_cast<int>(Nodes)));
+      });
+      timeOnce("inOrderTraverse", Nodes,
+         [&] { Tree->inOrderTraverse(sumVisitor); });
+      timeOnce("clear", Nodes, [&] { Tree->clear(); });
+   }
+
+   auto Adds = static_cast<long long>(Random.size());
+   BST<int, AvlBalance, Allocator> Avl;
+   timeOnce("random adds, AvlBalance", Adds, [&] {
+      for (int Key : Random)
+         Avl.add(Key);
+   });
+   timeOnce("clear", Adds, [&] { Avl.clear(); });
+}
+
+// lookups per second made by Threads readers, each calling Lookup on
+// random keys below Keys for half a second, while one more thread calls
+// Write with 0, 1, 2, ...
+template<class Lookup, class Write>
+static double readsPerSecond(int Threads, int Keys, Lookup lookup,
+   Write write) {
+   atomic<bool> Stop(false);
+   atomic<long long> Reads(0);
+   atomic<long long> Found(0);
+
+   thread Writer([&] {
+      for (int I = 0; !Stop.load(memory_order_relaxed); I++)
+         write(I);
+   });
+   vector<thread> Readers;
+   for (int T = 0; T < Threads; T++) {
+      Readers.emplace_back([&, T] {
+         mt19937 Rng(T + 1);
+         long long Count = 0;
+         long long Hits = 0;
+         while (!Stop.load(memory_order_relaxed)) {
+            Hits += lookup(static_cast<int>(Rng() % Keys));
+            Count++;
+         }
+         Reads += Count;
+         Found += Hits;
+      });
+   }
+
+   auto Start = chrono::steady_clock::now();
+   this_thread::sleep_for(chrono::milliseconds(500));
+   Stop = true;
+   for (thread& Reader : Readers)
+      Reader.join();
+   double Seconds = secondsSince(Start);
+   Writer.join();
+
+   Sink = Sink + Found;
+   return Reads / Seconds;
+}
+
+// read throughput of ConcurrentBST and of a locked BST as readers are
+// added, with one writer always active; the tree holds the even numbers
+// below 2 * Keys and the writer adds and removes odd ones
+static void timeReaders(int Keys, int MaxThreads) {
+   ConcurrentBST<int> Concurrent;
+   BST<int, AvlBalance> Locked;
+   mutex Lock;
+   for (int I = 0; I < Keys; I++) {
+      Concurrent.add(2 * I);
+      Locked.add(2 * I);
+   }
+
+   auto writeConcurrent = [&](int I) {
+      int Key = 2 * (I % Keys) + 1;
+      if (!Concurrent.add(Key)) Concurrent.remove(Key);
+   };
+   auto writeLocked = [&](int I) {
+      int Key = 2 * (I % Keys) + 1;
+      lock_guard<mutex> Guard(Lock);
+      if (!Locked.add(Key)) Locked.remove(Key);
+   };
+
+   cout << left << setw(10) << "readers" << right << setw(22)
+      << "ConcurrentBST" << setw(22) << "BST with mutex" << endl;
+   for (int Threads = 1; Threads <= MaxThreads; Threads *= 2) {
+      double Lockless = readsPerSecond(Threads, 2 * Keys,
+         [&](int Key) { return Concurrent.contains(Key); },
+         writeConcurrent);
+      double WithLock = readsPerSecond(Threads, 2 * Keys,
+         [&](int Key) {
+            lock_guard<mutex> Guard(Lock);
+            return Locked.contains(Key);
+         },
+         writeLocked);
+      cout << left << setw(10) << Threads << right << fixed
+         << setprecision(2) << setw(14) << Lockless / 1e6 << " M/s"
+         << setw(18) << WithLock / 1e6 << " M/s" << endl;
+   }
+}
+
+int main(int argc, char* argv[]) {
+   int Nodes = (argc > 1) ? atoi(argv[1]) : 10000000;
+   int Threads = (argc > 2) ? atoi(argv[2])
+      : max(1, static_cast<int>(thread::hardware_concurrency()));
+
+   vector<int> Sorted(Nodes);
+   for (int I = 0; I < Nodes; I++)
+      Sorted[I] = I;
+
+   cout << "balanced tree of " << Nodes << " nodes" << endl;
+   BST<int> Balanced(Sorted.data(), Nodes);
+   timeTraversals(Balanced, Nodes);
+
+   // every sorted add walks the whole spine, so keep this one small
+   const int SpineNodes = 30000;
+   cout << endl << "degenerate tree of " << SpineNodes << " nodes" << endl;
+   BST<int> Spine;
+   for (int I = 0; I < SpineNodes; I++)
+      Spine.add(I);
+   timeTraversals(Spine, SpineNodes);
+
+   // IDs that arrive almost in order
+   const int Adds = 200000;
+   vector<int> Keys(Adds);
+   mt19937 Rng(1);
+   for (int I = 0; I < Adds; I++)
+      Keys[I] = I * 16 + static_cast<int>(Rng() % 64);
+
+   cout << endl << Adds << " nearly sorted adds" << endl;
+   BST<int> Plain;
+   timeOnce("add, rebalance() per 1000", Adds, [&] {
+      for (int I = 0; I < Adds; I++) {
+         Plain.add(Keys[I]);
+         if (I % 1000 == 999) Plain.rebalance();
+      }
+   });
+   BST<int, AvlBalance> Avl;
+   timeOnce("add with AvlBalance", Adds, [&] {
+      for (int Key : Keys)
+         Avl.add(Key);
+   });
+   BST<int, ScapegoatBalance> Scapegoat;
+   timeOnce("add with ScapegoatBalance", Adds, [&] {
+      for (int Key : Keys)
+         Scapegoat.add(Key);
+   });
+   cout << "heights " << Plain.getHeight() << ", " << Avl.getHeight()
+      << " and " << Scapegoat.getHeight() << endl;
+
+   timeOnce("contains, rebalance()", Adds, [&] {
+      int Found = 0;
+      for (int Key : Keys)
+         Found += Plain.contains(Key + 1);
+      Sink = Sink + Found;
+   });
+   timeOnce("contains, AvlBalance", Adds, [&] {
+      int Found = 0;
+      for (int Key : Keys)
+         Found += Avl.contains(Key + 1);
+      Sink = Sink + Found;
+   });
+   timeOnce("contains, ScapegoatBalance", Adds, [&] {
+      int Found = 0;
+      for (int Key : Keys)
+         Found += Scapegoat.contains(Key + 1);
+      Sink = Sink + Found;
+   });
+   printPauses("rebalance() per 1000", Plain.pauses());
+   printPauses("ScapegoatBalance", Scapegoat.pauses());
+
+   vector<int> Random(Nodes / 20);
+   for (int& Key : Random)
+      Key = static_cast<int>(Rng());
+
+   cout << endl << "pauses with " << Random.size() << " random keys"
+      << endl;
+   {
+      BST<int> Unbalanced;
+      for (int Key : Random)
+         Unbalanced.add(Key);
+      Unbalanced.rebalance();
+      printPauses("one rebalance()", Unbalanced.pauses());
+
+      BST<int, ScapegoatBalance> Partial;
+      timeOnce("adds, ScapegoatBalance", static_cast<long long>(Random.size()),
+         [&] {
+            for (int Key : Random)
+               Partial.add(Key);
+         });
+      printPauses("rebuilds during adds", Partial.pauses());
+      timeOnce("removes, ScapegoatBalance", static_cast<long long>(
+         Random.size() / 2), [&] {
+            for (size_t I = 0; I < Random.size(); I += 2)
+               Partial.remove(Random[I]);
+         });
+      printPauses("rebuilds, adds and removes", Partial.pauses());
+   }
+
+   cout << endl << "Nodes from NodePool" << endl;
+   timeAllocator<NodePool<int>>(Sorted, Random);
+   cout << endl << "Nodes from std::allocator" << endl;
+   timeAllocator<allocator<int>>(Sorted, Random);
+
+   const int Lookups = 1000000;
+   vector<int> Probes(Lookups);
+   for (int& Probe : Probes)
+      Probe = static_cast<int>(Rng() % (2ULL * Nodes));
+
+   cout << endl << Lookups << " random lookups in " << Nodes << " nodes"
+      << endl;
+   BST<int> Tree(Sorted.data(), Nodes);
+   BSTSnapshot<int> Snapshot;
+   timeOnce("snapshot()", Nodes, [&] { Snapshot = Tree.snapshot(); });
+   timeOnce("BST contains", Lookups, [&] {
+      int Found = 0;
+      for (int Probe : Probes)
+         Found += Tree.contains(Probe);
+      Sink = Sink + Found;
+   });
+   timeOnce("snapshot contains", Lookups, [&] {
+      int Found = 0;
+      for (int Probe : Probes)
+         Found += Snapshot.contains(Probe);
+      Sink = Sink + Found;
+   });
+   timeOnce("snapshot lowerBound", Lookups, [&] {
+      long long Sum = 0;
+      for (int Probe : Probes) {
+         const int* Lower = Snapshot.lowerBound(Probe);
+         if (Lower != nullptr) Sum += *Lower;
+      }
+      Sink = Sink + Sum;
+   });
+   timeOnce("std::lower_bound on array", Lookups, [&] {
+      long long Sum = 0;
+      for (int Probe : Probes) {
+         auto Lower = lower_bound(Sorted.begin(), Sorted.end(), Probe);
+         if (Lower != Sorted.end()) Sum += *Lower;
+      }
+      Sink = Sink + Sum;
+   });
+
+   cout << endl << Lookups << " order statistics in " << Nodes << " nodes"
+      << endl;
+   timeOnce("countInRange", Lookups, [&] {
+      long long Sum = 0;
+      for (int Probe : Probes)
+         Sum += Tree.countInRange(Probe / 2, Probe / 2 + 1000);
+      Sink = Sink + Sum;
+   });
+   timeOnce("rank", Lookups, [&] {
+      long long Sum = 0;
+      for (int Probe : Probes)
+         Sum += Tree.rank(Probe);
+      Sink = Sink + Sum;
+   });
+   timeOnce("select", Lookups, [&] {
+      long long Sum = 0;
+      int Item = 0;
+      for (int Probe : Probes) {
+         Tree.select(Probe / 2, Item);
+         Sum += Item;
+      }
+      Sink = Sink + Sum;
+   });
+   const int Visits = Lookups / 100;
+   timeOnce("count with rangeVisit", Visits, [&] {
+      long long Sum = 0;
+      for (int I = 0; I < Visits; I++) {
+         int Lo = Probes[I] / 2;
+         Tree.rangeVisit(Lo, Lo + 1000, [&](const int&) { Sum++; });
+      }
+      Sink = Sink + Sum;
+   });
+   Tree.clear();
+
+   cout << endl << "bulk loads of " << Nodes << " nodes" << endl;
+   BST<int> Loaded;
+   timeOnce("buildFromSorted", Nodes,
+      [&] { Loaded.buildFromSorted(Sorted.begin(), Sorted.end()); });
+   {
+      unique_ptr<BST<int>> Copy;
+      timeOnce("copy constructor", Nodes,
+         [&] { Copy.reset(new BST<int>(Loaded)); });
+      timeOnce("assignment", Nodes, [&] { *Copy = Loaded; });
+   }
+   vector<int> Evens;
+   vector<int> Odds;
+   for (int I = 0; I < Nodes; I++)
+      (I % 2 == 0 ? Evens : Odds).push_back(I);
+   BST<int> Left;
+   BST<int> Right;
+   Left.buildFromSorted(Evens.begin(), Evens.end());
+   Right.buildFromSorted(Odds.begin(), Odds.end());
+   timeOnce("merge two halves", Nodes, [&] { Left.merge(Right); });
+   Left.clear();
+   Right.clear();
+
+   // keys too long for the string object itself, so each copy allocates
+   const int Strings = 1000000;
+   vector<string> Names(Strings);
+   for (int I = 0; I < Strings; I++)
+      Names[I] = "customer-record-" + to_string(Rng()) + "-" + to_string(I);
+
+   cout << endl << Strings << " string keys" << endl;
+   {
+      BST<string, AvlBalance> Copied;
+      countAllocations("add(const string&)", Strings, [&] {
+         for (const string& Name : Names)
+            Copied.add(Name);
+      });
+      vector<string> Spare(Names);
+      BST<string, AvlBalance> Moved;
+      countAllocations("add(string&&)", Strings, [&] {
+         for (string& Name : Spare)
+            Moved.add(move(Name));
+      });
+      countAllocations("contains(string(char*))", Strings, [&] {
+         int Found = 0;
+         for (const string& Name : Names)
+            Found += Moved.contains(string(Name.c_str()));
+         Sink = Sink + Found;
+      });
+      countAllocations("contains(char*)", Strings, [&] {
+         int Found = 0;
+         for (const string& Name : Names)
+            Found += Moved.contains(Name.c_str());
+         Sink = Sink + Found;
+      });
+   }
+
+   const int ReaderKeys = 1000000;
+   cout << endl << "lookups per second in " << ReaderKeys
+      << " nodes with one writer" << endl;
+   timeReaders(ReaderKeys, Threads);
+
+   return 0;
+}
@@ -0,0 +1,166 @@
+// Tanvir Tatla
+
+// BSTSnapshot class
+// Read-only copy of the Items of a BST, made by BST::snapshot(), laid out
+// for fast lookups in trees too large for the cache
+//   -- Items are stored in Eytzinger (breadth first) order: the root of a
+//      perfectly balanced tree at index 1, the children of index K at 2K
+//      and 2K + 1, so a lookup walks down an array instead of pointers
+//   -- lookups have no branch on the comparison: each step computes the
+//      next index as 2K + (Items[K] < Item)
+//   -- each step prefetches the cache line of the descendants a few levels
+//      down (16 for int), which the array starts on a cache line for
+//   -- later changes to the tree do not change a snapshot
+//
+// Implementation and assumptions:
+//   -- Items[0] is unused; an index of 0 means "not found"
+//   -- T needs a default constructor and operator<, like BST
+
+#ifndef BSTSNAPSHOT_HPP
+#define BSTSNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+// allocator whose memory starts on a cache line, so that the descendants
+// prefetched by BSTSnapshot share one line
+template<class T>
+class CacheLineAllocator {
+public:
+   using value_type = T;
+
+   static const size_t LineBytes = 64;
+
+   CacheLineAllocator() = default;
+
+   template<class U>
+   explicit CacheLineAllocator(const CacheLineAllocator<U>& /*Other*/) {}
+
+   // N objects starting on a cache line; the pointer operator new returned
+   // is kept just before them
+   T* allocate(size_t N) {
+      char* Raw = static_cast<char*>(
+         ::operator new(N * sizeof(T) + LineBytes + sizeof(void*)));
+      auto Start = reinterpret_cast<uintptr_t>(Raw + sizeof(void*));
+      Start = (Start + LineBytes - 1) & ~(uintptr_t(LineBytes) - 1);
+      auto P = reinterpret_cast<void**>(Start);
+      P[-1] = Raw;
+      return reinterpret_cast<T*>(P);
+   }
+
+   void deallocate(T* P, size_t /*N*/) noexcept {
+      ::operator delete(reinterpret_cast<void**>(P)[-1]);
+   }
+
+   template<class U>
+   bool operator==(const CacheLineAllocator<U>& /*Other*/) const {
+      return true;
+   }
+
+   template<class U>
+   bool operator!=(const CacheLineAllocator<U>& /*Other*/) const {
+      return false;
+   }
+};
+
+template<class T>
+class BSTSnapshot {
+public:
+   // constructor, empty snapshot
+   BSTSnapshot() : Items(1) {}
+
+   // snapshot of the N Items in Sorted, which are in ascending order
+   BSTSnapshot(const T Sorted[], int N) : Items(N + 1) {
+      int Next = 0;
+      fill(Sorted, Next, 1);
+   }
+
+   // number of Items
+   int size() const {
+      return static_cast<int>(Items.size()) - 1;
+   }
+
+   // true if no Items
+   bool isEmpty() const {
+      return size() == 0;
+   }
+
+   // true if Item is in the snapshot
+   bool contains(const T& Item) const {
+      size_t K = lowerBoundIndex(Item);
+      return K != 0 && !(Item < Items[K]);
+   }
+
+   // smallest Item that is not less than Item, nullptr if there is none
+   const T* lowerBound(const T& Item) const {
+      size_t K = lowerBoundIndex(Item);
+      return (K == 0 ? nullptr : &Items[K]);
+   }
+
+private:
+   // Items in Eytzinger order, from index 1
+   vector<T, CacheLineAllocator<T>> Items;
+
+   // Items per cache line (at least 1): the descendants of K that many
+   // levels apart are K * ItemsPerLine and the ones after it
+   static const size_t ItemsPerLine =
+      sizeof(T) >= CacheLineAllocator<T>::LineBytes ? 1
+      : CacheLineAllocator<T>::LineBytes / sizeof(T);
+
+   // put Sorted[Next], Sorted[Next + 1], ... into the subtree at K in
+   // inorder, so the array reads back in ascending order
+   // recursion depth is log2 of the number of Items
+   void fill(const T Sorted[], int& Next, size_t K) {
+      if (K >= Items.size()) return;
+
+      fill(Sorted, Next, 2 * K);
+      Items[K] = Sorted[Next++];
+      fill(Sorted, Next, 2 * K + 1);
+   }
+
+   // index of the smallest Item not less than Item, 0 if there is none
+   // walks down to a leaf going right whenever Items[K] < Item; the answer
+   // is where the walk last went left, found by dropping the trailing
+   // 1 bits (right turns) and the 0 bit (left turn) before them
+   size_t lowerBoundIndex(const T& Item) const {
+      size_t N = Items.size();
+      size_t K = 1;
+      while (K < N) {
+         prefetch(K * ItemsPerLine);
+         K = 2 * K + static_cast<size_t>(Items[K] < Item);
+      }
+      K >>= countTrailingOnes(K) + 1;
+      return K;
+   }
+
+   // ask for the cache line holding Items[K]; K may be past the end
+   void prefetch(size_t K) const {
+#if defined(__GNUC__)
+      __builtin_prefetch(reinterpret_cast<const void*>(
+         reinterpret_cast<uintptr_t>(Items.data()) + K * sizeof(T)));
+#else
+      (void)K;
+#endif
+   }
+
+   // number of 1 bits below the lowest 0 bit of K
+   static int countTrailingOnes(size_t K) {
+#if defined(__GNUC__)
+      return (~K == 0 ? 64 : __builtin_ctzll(~K));
+#else
+      int Count = 0;
+      for (; K & 1; K >>= 1)
+         Count++;
+      return Count;
+#endif
+   }
+};
+
+template<class T>
+const size_t BSTSnapshot<T>::ItemsPerLine;
+
+#endif
@@ -17,9 +17,13 @@
  */
 
 #include "bst.hpp"
+#include "concurrentbst.hpp"
+#include <atomic>
 #include <cassert>
 #include <iostream>
+#include <list>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -307,6 +311,612 @@ void testTatla03() {
    cout << "Ending testTatla03" << endl;
 }
 
+void testTatla04() {
+   cout << "Starting testTatla04" << endl;
+   cout << "* Testing iterators" << endl;
+
+   BST<int> B1;
+   assert(B1.begin() == B1.end());
+   for (auto& S : vector<int>{ 8,4,12,2,6,10,14,1,3,5,7,9,11,13,15 })
+      B1.add(S);
+
+   vector<int> Items(B1.begin(), B1.end());
+   assert(Items == vector<int>({ 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15 }));
+
+   // walk backwards from end()
+   auto It = B1.end();
+   for (int I = 15; I >= 1; I--) {
+      --It;
+      assert(*It == I);
+   }
+   assert(It == B1.begin());
+
+   int Sum = 0;
+   for (int I : B1)
+      Sum += I;
+   assert(Sum == 120);
+
+   cout << "* Testing traversals of a degenerate tree" << endl;
+   // sorted adds make a tree that is one long right spine
+   const int N = 10000;
+   BST<int> B2;
+   for (int I = 0; I < N; I++)
+      B2.add(I);
+   assert(B2.getHeight() == N);
+   assert(B2.numberOfNodes() == N);
+
+   TreeVisitor::resetSS();
+   B2.postOrderTraverse(TreeVisitor::visitor);
+   string Result = TreeVisitor::getSS();
+   assert(Result.substr(0, 9) == "999999989" && Result.back() == '0');
+
+   BST<int> B3(B2);
+   assert(B2 == B3);
+   B3.remove(N - 1);
+   assert(B2 != B3);
+   assert(*--B3.end() == N - 2);
+
+   // preorder of a mix of left and right children
+   BST<int> B4;
+   for (auto& S : vector<int>{ 5,1,9,3,7,2 })
+      B4.add(S);
+   TreeVisitor::resetSS();
+   B4.preOrderTraverse(TreeVisitor::visitor);
+   assert(TreeVisitor::getSS() == "513297");
+   TreeVisitor::resetSS();
+   B4.postOrderTraverse(TreeVisitor::visitor);
+   assert(TreeVisitor::getSS() == "231795");
+
+   B2.clear();
+   assert(B2.isEmpty() && B2.begin() == B2.end());
+   cout << "Ending testTatla04" << endl;
+}
+
+void testTatla05() {
+   cout << "Starting testTatla05" << endl;
+   cout << "* Testing AvlBalance" << endl;
+
+   // sorted adds stay balanced
+   BST<int, AvlBalance> B1;
+   for (int I = 1; I <= 7; I++)
+      B1.add(I);
+   assert(B1.getHeight() == 3);
+
+   TreeVisitor::resetSS();
+   B1.preOrderTraverse(TreeVisitor::visitor);
+   assert(TreeVisitor::getSS() == "4213657");
+
+   // same shape as the array constructor builds
+   int Arr[7] = { 1,2,3,4,5,6,7 };
+   BST<int, AvlBalance> B2(Arr, 7);
+   assert(B1 == B2);
+
+   // double rotations: 3,1,2 and 1,3,2 both end up with 2 at the Root
+   BST<int, AvlBalance> B3;
+   for (auto& S : vector<int>{ 3,1,2 })
+      B3.add(S);
+   BST<int, AvlBalance> B4;
+   for (auto& S : vector<int>{ 1,3,2 })
+      B4.add(S);
+   TreeVisitor::resetSS();
+   B3.preOrderTraverse(TreeVisitor::visitor);
+   assert(TreeVisitor::getSS() == "213");
+   assert(B3 == B4);
+
+   const int N = 100000;
+   BST<int, AvlBalance> B5;
+   for (int I = 0; I < N; I++)
+      B5.add(I);
+   assert(B5.numberOfNodes() == N);
+   assert(B5.getHeight() <= 1.45 * log2(N + 2));
+
+   cout << "* Testing remove with AvlBalance" << endl;
+   // remove every even Item, then the upper half of the odd ones
+   for (int I = 0; I < N; I += 2)
+      assert(B5.remove(I));
+   for (int I = N / 2 + 1; I < N; I += 2)
+      assert(B5.remove(I));
+   assert(B5.numberOfNodes() == N / 4);
+   assert(B5.getHeight() <= 1.45 * log2(N / 4 + 2));
+
+   int Expected = 1;
+   for (int I : B5) {
+      assert(I == Expected);
+      Expected += 2;
+   }
+
+   // copies keep the structure
+   BST<int, AvlBalance> B6(B5);
+   assert(B5 == B6);
+   assert(B6.getHeight() == B5.getHeight());
+   cout << "Ending testTatla05" << endl;
+}
+
+void testTatla06() {
+   cout << "Starting testTatla06" << endl;
+   cout << "* Testing NodePool" << endl;
+
+   NodePool<int> Pool;
+   assert(Pool.blocks() == 0);
+   int* A = Pool.allocate(1);
+   int* B = Pool.allocate(1);
+   assert(A != B && Pool.blocks() == 1);
+   Pool.deallocate(A, 1);
+   assert(Pool.allocate(1) == A); // freed slots are reused first
+
+   // blocks double in size: 64 + 128 + 256 slots hold 448 objects
+   for (int I = 2; I < 448; I++)
+      Pool.allocate(1);
+   assert(Pool.blocks() == 3);
+   Pool.allocate(1);
+   assert(Pool.blocks() == 4);
+
+   // copies share blocks and compare equal; either can free the other's
+   NodePool<int> Copy(Pool);
+   assert(Copy == Pool && Copy.blocks() == 4);
+   int* C = Copy.allocate(1);
+   Pool.deallocate(C, 1);
+   assert(Pool.allocate(1) == C);
+   NodePool<int> Assigned;
+   assert(Assigned != Pool);
+   Assigned = Copy;
+   assert(Assigned == Pool);
+   assert(Pool.select_on_container_copy_construction() != Pool);
+
+   NodePool<int> Moved(std::move(Pool));
+   assert(Pool.blocks() == 0 && Moved.blocks() == 4 && Moved == Copy);
+   assert(Pool.allocate(1) != nullptr && Pool.blocks() == 1);
+   Moved.release();
+   assert(Moved.blocks() == 0 && Copy.blocks() == 0);
+
+   // a container that rebinds the pool to its own node type
+   list<int, NodePool<int>> L1;
+   for (int I = 0; I < 100; I++)
+      L1.push_back(I);
+   list<int, NodePool<int>> L2(L1);
+   L1.clear();
+   assert(L2.size() == 100 && L2.back() == 99);
+
+   cout << "* Testing BST with NodePool and std::allocator" << endl;
+   // strings must be destroyed before the pool frees its blocks
+   BST<string> B1;
+   for (int I = 0; I < 1000; I++)
+      B1.add("item number " + to_string(I));
+   for (int I = 0; I < 1000; I += 2)
+      B1.remove("item number " + to_string(I));
+   assert(B1.numberOfNodes() == 500);
+   BST<string> B2(B1);
+   B1.clear();
+   assert(B1.isEmpty() && B2.numberOfNodes() == 500);
+   B1.add("again");
+   assert(B1.contains("again") && !B1.contains("item number 1"));
+
+   BST<int, AvlBalance, allocator<int>> B3;
+   BST<int, AvlBalance> B4;
+   for (int I = 0; I < 1000; I++) {
+      B3.add(I);
+      B4.add(I);
+   }
+   assert(vector<int>(B3.begin(), B3.end()) ==
+      vector<int>(B4.begin(), B4.end()));
+   B3.clear();
+   assert(B3.isEmpty());
+   cout << "Ending testTatla06" << endl;
+}
+
+void testTatla07() {
+   cout << "Starting testTatla07" << endl;
+   cout << "* Testing snapshot" << endl;
+
+   BST<int> B1;
+   BSTSnapshot<int> S1 = B1.snapshot();
+   assert(S1.isEmpty() && !S1.contains(0) && S1.lowerBound(0) == nullptr);
+
+   // every size up to 100, so that the last level is filled to every width
+   for (int N = 1; N <= 100; N++) {
+      B1.add(N * 10);
+      BSTSnapshot<int> S2 = B1.snapshot();
+      assert(S2.size() == N);
+      for (int I = 0; I <= N * 10 + 10; I++) {
+         assert(S2.contains(I) == (I % 10 == 0 && I > 0 && I <= N * 10));
+         const int* Lower = S2.lowerBound(I);
+         if (I > N * 10) {
+            assert(Lower == nullptr);
+         }
+         else {
+            assert(Lower != nullptr);
+            assert(*Lower == max(10, (I + 9) / 10 * 10));
+         }
+      }
+   }
+
+   // a snapshot does not follow later changes
+   BSTSnapshot<int> S3 = B1.snapshot();
+   B1.remove(500);
+   assert(S3.contains(500) && !B1.contains(500));
+
+   BST<string> B2;
+   for (auto& S : vector<string>{ "pear", "apple", "fig", "kiwi" })
+      B2.add(S);
+   BSTSnapshot<string> S4 = B2.snapshot();
+   assert(S4.contains("fig") && !S4.contains("grape"));
+   assert(*S4.lowerBound("grape") == "kiwi");
+   assert(*S4.lowerBound("a") == "apple");
+   assert(S4.lowerBound("plum") == nullptr);
+   cout << "Ending testTatla07" << endl;
+}
+
+void testTatla08() {
+   cout << "Starting testTatla08" << endl;
+   cout << "* Testing size, rank and select" << endl;
+
+   BST<int, AvlBalance> B1;
+   int Item = -1;
+   assert(B1.size() == 0 && B1.rank(5) == 0 && !B1.select(0, Item));
+   assert(Item == -1);
+
+   // the even numbers 0 .. 198, added out of order
+   for (int I = 0; I < 100; I++)
+      B1.add((I * 37 % 100) * 2);
+   assert(B1.size() == 100 && B1.numberOfNodes() == 100);
+
+   for (int I = 0; I < 100; I++) {
+      assert(B1.rank(2 * I) == I);
+      assert(B1.rank(2 * I + 1) == I + 1);
+      assert(B1.select(I, Item) && Item == 2 * I);
+   }
+   assert(B1.rank(-1) == 0 && B1.rank(1000) == 100);
+   assert(!B1.select(100, Item) && !B1.select(-1, Item));
+
+   cout << "* Testing countInRange and rangeVisit" << endl;
+   assert(B1.countInRange(0, 198) == 100);
+   assert(B1.countInRange(10, 20) == 6);
+   assert(B1.countInRange(11, 19) == 4);
+   assert(B1.countInRange(-50, -1) == 0);
+   assert(B1.countInRange(20, 10) == 0);
+   assert(B1.countInRange(198, 500) == 1);
+
+   vector<int> Visited;
+   B1.rangeVisit(11, 19, [&](const int& I) { Visited.push_back(I); });
+   assert(Visited == vector<int>({ 12,14,16,18 }));
+
+   TreeVisitor::resetSS();
+   B1.rangeVisit(190, 1000, TreeVisitor::visitor);
+   assert(TreeVisitor::getSS() == "190192194196198");
+
+   // sizes stay right through removes, rotations and copies
+   for (int I = 0; I < 200; I += 4)
+      B1.remove(I);
+   assert(B1.size() == 50 && B1.countInRange(0, 20) == 5);
+   assert(B1.select(0, Item) && Item == 2);
+   BST<int, AvlBalance> B2(B1);
+   assert(B2.size() == 50 && B2.rank(198) == 49);
+   B2.rebalance();
+   assert(B2.size() == 50 && B2.select(49, Item) && Item == 198);
+
+   // plain BST keeps sizes as well
+   BST<int> B3;
+   for (int I = 0; I < 10; I++)
+      B3.add(I);
+   assert(B3.rank(7) == 7 && B3.countInRange(3, 5) == 3);
+   cout << "Ending testTatla08" << endl;
+}
+
+void testTatla09() {
+   cout << "Starting testTatla09" << endl;
+   cout << "* Testing buildFromSorted" << endl;
+
+   vector<int> Sorted{ 1,2,3,4,5,6,7 };
+   BST<int> B1(99);
+   assert(B1.buildFromSorted(Sorted.begin(), Sorted.end()));
+   int Arr[7] = { 1,2,3,4,5,6,7 };
+   BST<int> B2(Arr, 7);
+   assert(B1 == B2); // same shape as the array constructor
+
+   // repeated Items are kept once, unsorted input changes nothing
+   vector<int> Repeats{ 1,1,2,3,3,3 };
+   assert(B1.buildFromSorted(Repeats.begin(), Repeats.end()));
+   assert(B1.size() == 3 && B1.getHeight() == 2);
+   vector<int> Unsorted{ 1,3,2 };
+   assert(!B1.buildFromSorted(Unsorted.begin(), Unsorted.end()));
+   assert(B1.size() == 3);
+   assert(B1.buildFromSorted(Unsorted.begin(), Unsorted.begin()));
+   assert(B1.isEmpty());
+
+   BST<string, AvlBalance> B3;
+   vector<string> Words{ "ant", "bee", "cat", "dog", "eel" };
+   assert(B3.buildFromSorted(Words.begin(), Words.end()));
+   B3.add("fox"); // still an AVL tree afterwards
+   B3.add("gnu");
+   assert(B3.getHeight() == 4 && B3.size() == 7);
+
+   cout << "* Testing assignment" << endl;
+   BST<int> B4;
+   B4 = B2;
+   assert(B4 == B2);
+   B4.remove(4);
+   assert(B4 != B2 && B2.contains(4));
+   BST<int>& Same = B4;
+   B4 = Same; // assigning to self changes nothing
+   assert(B4.size() == 6);
+   B4 = BST<int>();
+   assert(B4.isEmpty());
+
+   cout << "* Testing merge" << endl;
+   BST<int, AvlBalance> B5;
+   BST<int, AvlBalance> B6;
+   for (int I = 0; I < 100; I += 2)
+      B5.add(I);
+   for (int I = 0; I < 150; I += 3)
+      B6.add(I);
+   B5.merge(B6);
+   assert(B5.size() == 50 + 50 - 17);
+   assert(B5.countInRange(0, 5) == 4); // 0 2 3 4
+   assert(B5.getHeight() == 7);
+   B5.merge(B5);
+   assert(B5.size() == 83);
+   assert(B6.size() == 50);
+   cout << "Ending testTatla09" << endl;
+}
+
+// Item type that counts its copies, and compares with int without
+// converting to CopyCounter
+class CopyCounter {
+public:
+   static int Copies;
+   int Value{ 0 };
+
+   CopyCounter() = default;
+   explicit CopyCounter(int V) : Value(V) {}
+   CopyCounter(int A, int B) : Value(A * B) {}
+   CopyCounter(const CopyCounter& Other) : Value(Other.Value) {
+      Copies++;
+   }
+   CopyCounter(CopyCounter&& Other) noexcept = default;
+   CopyCounter& operator=(const CopyCounter& Other) {
+      Value = Other.Value;
+      Copies++;
+      return *this;
+   }
+   CopyCounter& operator=(CopyCounter&& Other) noexcept = default;
+   ~CopyCounter() = default;
+
+   bool operator<(const CopyCounter& Other) const {
+      return Value < Other.Value;
+   }
+   bool operator>(const CopyCounter& Other) const {
+      return Value > Other.Value;
+   }
+   bool operator==(const CopyCounter& Other) const {
+      return Value == Other.Value;
+   }
+   friend bool operator<(int Lhs, const CopyCounter& Rhs) {
+      return Lhs < Rhs.Value;
+   }
+   friend bool operator<(const CopyCounter& Lhs, int Rhs) {
+      return Lhs.Value < Rhs;
+   }
+};
+
+// Item type made implicitly from an int, that only compares with itself
+class Wrapped {
+public:
+   int Value{ 0 };
+
+   Wrapped(int V) : Value(V) {}
+
+   bool operator<(const Wrapped& Other) const {
+      return Value < Other.Value;
+   }
+   bool operator>(const Wrapped& Other) const {
+      return Value > Other.Value;
+   }
+};
+
+int CopyCounter::Copies = 0;
+
+void testTatla10() {
+   cout << "Starting testTatla10" << endl;
+   cout << "* Testing add with move and emplace" << endl;
+
+   BST<CopyCounter, AvlBalance> B1;
+   CopyCounter::Copies = 0;
+   for (int I = 0; I < 100; I++)
+      assert(B1.add(CopyCounter(I)));
+   assert(B1.emplace(10, 20)); // CopyCounter(200)
+   assert(B1.emplace(300));
+   assert(!B1.emplace(5, 4)); // 20 is already there
+   assert(!B1.add(CopyCounter(7)));
+   assert(CopyCounter::Copies == 0);
+   assert(B1.size() == 102);
+
+   CopyCounter Item(42);
+   B1.add(Item); // a duplicate, but passed by const reference
+   B1.add(CopyCounter(500));
+   assert(CopyCounter::Copies == 0);
+   B1.add(CopyCounter(501)); // force rotations, still no copies
+   assert(CopyCounter::Copies == 0 && B1.size() == 104);
+
+   cout << "* Testing contains with other key types" << endl;
+   assert(B1.contains(200) && B1.contains(99) && !B1.contains(100));
+   assert(B1.contains(CopyCounter(300)));
+   assert(CopyCounter::Copies == 0);
+
+   BST<string> B2;
+   string Long = "a string too long to fit in the string object";
+   assert(B2.add(move(Long)));
+   assert(B2.contains("a string too long to fit in the string object"));
+   assert(!B2.contains("short"));
+   const char* Key = "short";
+   assert(!B2.contains(Key));
+   static_assert(IsHeterogeneousKey<string, const char*>::value,
+      "const char* is looked up without making a string");
+
+   // keys that convert to the Item type are converted, not compared
+   static_assert(!IsHeterogeneousKey<int, double>::value,
+      "double converts to int");
+   BST<int> Ints;
+   Ints.add(3);
+   assert(Ints.contains(3.5) && !Ints.contains(4.5));
+   BST<Wrapped> Wraps;
+   Wraps.add(1);
+   assert(Wraps.contains(1) && !Wraps.contains(2));
+
+   cout << "* Testing move constructor and assignment" << endl;
+   static_assert(is_nothrow_move_constructible<BST<int>>::value,
+      "BST moves must not throw");
+   static_assert(is_nothrow_move_assignable<BST<int>>::value,
+      "BST moves must not throw");
+
+   BST<CopyCounter, AvlBalance> B3(move(B1));
+   assert(B1.isEmpty() && B3.size() == 104);
+   B1.add(CopyCounter(1)); // moved-from tree is usable
+   assert(B1.size() == 1);
+   B1 = move(B3);
+   assert(B3.isEmpty() && B1.size() == 104 && B1.contains(501));
+   assert(CopyCounter::Copies == 0);
+
+   BST<int, NoBalance, allocator<int>> B4;
+   B4.add(1);
+   BST<int, NoBalance, allocator<int>> B5;
+   B5 = move(B4);
+   assert(B5.contains(1) && B4.isEmpty());
+
+   // removing a Node with 2 children moves the successor's Item
+   B1.remove(CopyCounter(50));
+   assert(CopyCounter::Copies == 0 && !B1.contains(50));
+   cout << "Ending testTatla10" << endl;
+}
+
+void testTatla11() {
+   cout << "Starting testTatla11" << endl;
+   cout << "* Testing ConcurrentBST on one thread" << endl;
+
+   ConcurrentBST<int> C1;
+   assert(C1.isEmpty() && C1.getHeight() == 0 && !C1.contains(1));
+   for (int I = 0; I < 1000; I++)
+      assert(C1.add(I));
+   assert(!C1.add(500));
+   assert(C1.size() == 1000 && C1.getHeight() <= 11);
+   for (int I = 0; I < 1000; I += 3)
+      assert(C1.remove(I));
+   assert(!C1.remove(0) && !C1.remove(1000));
+   assert(C1.size() == 666 && C1.getHeight() <= 11);
+
+   vector<int> Items;
+   C1.forEach([&Items](int Item) { Items.push_back(Item); });
+   assert(Items.size() == 666);
+   for (int I = 0; I < 666; I++)
+      assert(Items[I] == I / 2 * 3 + 1 + I % 2);
+
+   C1.clear();
+   assert(C1.isEmpty() && C1.size() == 0);
+   C1.add(7);
+   assert(C1.contains(7) && C1.size() == 1);
+
+   cout << "* Testing ConcurrentBST readers while a writer runs" << endl;
+   // even Items are always there, odd Items come and go
+   ConcurrentBST<int> C2;
+   const int Keys = 2000;
+   for (int I = 0; I < Keys; I += 2)
+      C2.add(I);
+
+   atomic<bool> Done(false);
+   atomic<int> Failures(0);
+   vector<thread> Readers;
+   for (int R = 0; R < 3; R++) {
+      Readers.emplace_back([&C2, &Done, &Failures, R] {
+         int Key = R;
+         while (!Done.load()) {
+            Key = (Key + 7) % Keys;
+            if (Key % 2 == 0 && !C2.contains(Key)) Failures++;
+
+            // a traversal sees one version: sorted, with every even Item
+            int Evens = 0;
+            int Last = -1;
+            C2.forEach([&Evens, &Last, &Failures](int Item) {
+               if (Item <= Last) Failures++;
+               if (Item % 2 == 0) Evens++;
+               Last = Item;
+            });
+            if (Evens != Keys / 2) Failures++;
+         }
+      });
+   }
+
+   // enough changes for several batches of retired Nodes to be freed
+   for (int Round = 0; Round < 20; Round++) {
+      for (int I = 1; I < Keys; I += 2)
+         assert(C2.add(I));
+      for (int I = 1; I < Keys; I += 2)
+         assert(C2.remove(I));
+   }
+   Done = true;
+   for (thread& Reader : Readers)
+      Reader.join();
+
+   assert(Failures == 0);
+   assert(C2.size() == Keys / 2 && C2.getHeight() <= 11);
+   cout << "Ending testTatla11" << endl;
+}
+
+void testTatla12() {
+   cout << "Starting testTatla12" << endl;
+   cout << "* Testing PauseHistogram" << endl;
+
+   PauseHistogram H;
+   assert(H.count() == 0 && H.percentile(99) == 0);
+   H.record(0);
+   H.record(1);
+   H.record(3);
+   H.record(1000);
+   assert(H.count() == 4 && H.total() == 1004 && H.longest() == 1000);
+   assert(H.count(0) == 2 && H.count(1) == 1 && H.count(9) == 1);
+   assert(H.percentile(50) == 1 && H.percentile(75) == 3);
+   assert(H.percentile(100) == 1000);
+   H.clear();
+   assert(H.count() == 0 && H.count(0) == 0 && H.longest() == 0);
+
+   cout << "* Testing ScapegoatBalance" << endl;
+   // sorted adds would make a spine of 10000 Nodes without balancing;
+   // weight balance keeps the height below log(n) / log(3/2) + 1
+   BST<int, ScapegoatBalance> B1;
+   for (int I = 0; I < 10000; I++)
+      assert(B1.add(I));
+   assert(!B1.add(5000));
+   assert(B1.size() == 10000 && B1.getHeight() <= 23);
+   assert(B1.pauses().count() > 0);
+   int Item = 0;
+   assert(B1.rank(1234) == 1234 && B1.select(9999, Item) && Item == 9999);
+
+   // removing from one end unbalances the tree the other way
+   for (int I = 0; I < 9000; I++)
+      assert(B1.remove(I));
+   assert(B1.size() == 1000 && B1.getHeight() <= 18);
+   int Expected = 9000;
+   for (int I : B1)
+      assert(I == Expected++);
+   assert(Expected == 10000 && B1.countInRange(9500, 9599) == 100);
+
+   BST<int, ScapegoatBalance> B2;
+   for (int I = 100; I > 0; I--)
+      assert(B2.emplace(I));
+   assert(!B2.emplace(50) && B2.size() == 100 && B2.getHeight() <= 12);
+
+   cout << "* Testing rebalance pauses" << endl;
+   BST<int> B3;
+   for (int I = 0; I < 100; I++)
+      B3.add(I);
+   assert(B3.pauses().count() == 0 && B3.getHeight() == 100);
+   B3.rebalance();
+   assert(B3.pauses().count() == 1 && B3.getHeight() == 7);
+   assert(B3.size() == 100 && B3.rank(50) == 50);
+   BST<int> Empty;
+   Empty.rebalance();
+   assert(Empty.isEmpty() && Empty.pauses().count() == 0);
+   cout << "Ending testTatla12" << endl;
+}
+
 // Calling all test functions
 void testBSTAll() {
   testPisan01();
@@ -316,4 +926,13 @@ void testBSTAll() {
   testTatla01();
   testTatla02();
   testTatla03();
-}
\ No newline at end of file
+  testTatla04();
+  testTatla05();
+  testTatla06();
+  testTatla07();
+  testTatla08();
+  testTatla09();
+  testTatla10();
+  testTatla11();
+  testTatla12();
+}
\ No newline at end of file
@@ -0,0 +1,472 @@
+// Tanvir Tatla
+
+// ConcurrentBST class
+// Set of Items kept in order, for many threads reading while a few write
+//   -- contains, size, getHeight and inOrderTraverse never take a lock and
+//      never wait for a writer, however long the writer takes
+//   -- add, remove and clear are serialized by a mutex
+//   -- the tree is an AVL tree whose Nodes never change once other threads
+//      can see them: a writer copies the path from the Root to the Nodes
+//      it changes (O(log n) new Nodes) and publishes the new Root with one
+//      atomic store, so a reader sees the whole tree before or after a
+//      change, never a mix
+//   -- inOrderTraverse visits one consistent version of the tree, even
+//      while writers change it
+//
+// Implementation and assumptions:
+//   -- Nodes replaced by a writer are retired, and freed once every reader
+//      that could still see them has finished (a grace period), in batches
+//      of RetireBatch Nodes; the grace period is detected like SRCU:
+//      readers count themselves into one of two sets of striped counters
+//      chosen by Phase, and a writer flips Phase twice, each time waiting
+//      for the counters of the old phase to drain
+//   -- so a long traversal delays the writer that frees the next batch,
+//      but never another reader; a thread must not call a writing
+//      function from inside the Visit of a traversal
+//   -- counters are padded to a cache line and a thread always uses the
+//      same stripe, so readers on different cores do not share lines; they
+//      are allocated on their own with aligned allocation, since new of a
+//      ConcurrentBST is not over-aligned in C++14
+//   -- Nodes come from a NodePool used only by writers (under the mutex)
+//   -- if add or remove throws, the tree is unchanged, but the Nodes it
+//      made are only given back when the tree is destroyed
+//   -- the destructor and clear must not run while any thread reads
+//   -- T needs a copy constructor and operator<
+//   -- objects can not be copied or assigned
+
+#ifndef CONCURRENTBST_HPP
+#define CONCURRENTBST_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include "nodepool.hpp"
+
+using namespace std;
+
+template<class T>
+class ConcurrentBST {
+public:
+   // constructor, empty tree
+   ConcurrentBST() : Readers(newCounters()) {}
+
+   // destructor, frees every Node; no other thread may be using the tree
+   ~ConcurrentBST() {
+      freeTree(Root.load(memory_order_relaxed));
+      deleteCounters(Readers);
+   }
+
+   ConcurrentBST(const ConcurrentBST&) = delete;
+   ConcurrentBST& operator=(const ConcurrentBST&) = delete;
+
+   // add a new item, return true if successful (false if duplicate)
+   bool add(const T& Item) {
+      lock_guard<mutex> Guard(WriteLock);
+
+      bool Added = false;
+      const Node* NewRoot = nullptr;
+      size_t Mark = Retired.size();
+      try {
+         NewRoot = insert(Root.load(memory_order_relaxed), Item, Added);
+      }
+      catch (...) {
+         // the tree is unchanged; Nodes made so far stay in the pool
+         Retired.resize(Mark);
+         throw;
+      }
+      if (!Added) return false;
+
+      publish(NewRoot);
+      Count.store(Count.load(memory_order_relaxed) + 1,
+         memory_order_relaxed);
+      return true;
+   }
+
+   // remove item, return true if successful
+   bool remove(const T& Item) {
+      lock_guard<mutex> Guard(WriteLock);
+
+      bool Removed = false;
+      const Node* NewRoot = nullptr;
+      size_t Mark = Retired.size();
+      try {
+         NewRoot = erase(Root.load(memory_order_relaxed), Item, Removed);
+      }
+      catch (...) {
+         // the tree is unchanged; Nodes made so far stay in the pool
+         Retired.resize(Mark);
+         throw;
+      }
+      if (!Removed) return false;
+
+      publish(NewRoot);
+      Count.store(Count.load(memory_order_relaxed) - 1,
+         memory_order_relaxed);
+      return true;
+   }
+
+   // delete all nodes in tree; no other thread may be reading
+   void clear() {
+      lock_guard<mutex> Guard(WriteLock);
+
+      freeTree(Root.exchange(nullptr));
+      Count.store(0, memory_order_relaxed);
+   }
+
+   // true if item is in the tree, lock-free
+   bool contains(const T& Item) const {
+      ReadSection Section(*this);
+
+      const Node* Current = Root.load();
+      while (Current != nullptr) {
+         if (Item < Current->Data) Current = Current->Left;
+         else if (Current->Data < Item) Current = Current->Right;
+         else return true;
+      }
+
+      return false;
+   }
+
+   // number of Items, as of the last completed add or remove
+   int size() const {
+      return Count.load(memory_order_relaxed);
+   }
+
+   // true if no nodes in the tree
+   bool isEmpty() const {
+      return Root.load() == nullptr;
+   }
+
+   // 0 if empty, 1 if only root, otherwise
+   // height of root is max height of subtrees + 1
+   int getHeight() const {
+      ReadSection Section(*this);
+      return height(Root.load());
+   }
+
+   // inorder traversal: left-root-right, of the tree as it was when the
+   // traversal started, lock-free
+   // takes a function that takes a single parameter of type T
+   void inOrderTraverse(void Visit(const T& Item)) const {
+      forEach(Visit);
+   }
+
+   // inOrderTraverse for any function object
+   template<class Visit>
+   void forEach(Visit visit) const {
+      ReadSection Section(*this);
+
+      // the height of an AVL tree of 2^31 Nodes is below 45
+      const Node* Stack[MaxHeight];
+      int Top = 0;
+      const Node* Current = Root.load();
+      while (Current != nullptr || Top > 0) {
+         while (Current != nullptr) {
+            Stack[Top++] = Current;
+            Current = Current->Left;
+         }
+         Current = Stack[--Top];
+         visit(Current->Data);
+         Current = Current->Right;
+      }
+   }
+
+private:
+   // Node of the tree; never changed once reachable from Root
+   struct Node {
+      T Data;
+      const Node* Left;
+      const Node* Right;
+      int Height; // 1 for a leaf
+
+      Node(const T& Item, const Node* L, const Node* R)
+         : Data(Item), Left(L), Right(R),
+         Height(1 + max(height(L), height(R))) {}
+   };
+
+   // reader counter, padded to a cache line
+   struct alignas(64) Counter {
+      atomic<long> Readers{ 0 };
+   };
+
+   // number of reader counter stripes per phase
+   static const int Stripes = 64;
+
+   // retired Nodes collected before a grace period frees them
+   static const int RetireBatch = 4096;
+
+   // more than the height of any AVL tree that fits in memory
+   static const int MaxHeight = 64;
+
+   // root of the current version of the tree
+   atomic<const Node*> Root{ nullptr };
+
+   // number of Items
+   atomic<int> Count{ 0 };
+
+   // held by writers
+   mutex WriteLock;
+
+   // where Nodes come from, used by writers only
+   NodePool<Node> Pool;
+
+   // Nodes no longer in the tree that readers may still see
+   vector<const Node*> Retired;
+
+   // readers in each phase, per stripe: phase P's counters are
+   // Readers[P * Stripes] to Readers[P * Stripes + Stripes - 1]
+   Counter* const Readers;
+
+   // phase new readers count themselves in
+   atomic<int> Phase{ 0 };
+
+   // marks a reader from construction to destruction
+   class ReadSection {
+   public:
+      explicit ReadSection(const ConcurrentBST& Tree) {
+         Slot = &Tree.Readers[Tree.Phase.load() * Stripes + stripe()].Readers;
+         Slot->fetch_add(1);
+      }
+
+      ~ReadSection() {
+         Slot->fetch_sub(1, memory_order_release);
+      }
+
+      ReadSection(const ReadSection&) = delete;
+      ReadSection& operator=(const ReadSection&) = delete;
+
+   private:
+      atomic<long>* Slot;
+   };
+
+   // both phases' reader counters, each on its own cache line
+   static Counter* newCounters() {
+      void* Memory = nullptr;
+      size_t Bytes = 2 * Stripes * sizeof(Counter);
+#if defined(_WIN32)
+      Memory = _aligned_malloc(Bytes, alignof(Counter));
+#else
+      if (posix_memalign(&Memory, alignof(Counter), Bytes) != 0)
+         Memory = nullptr;
+#endif
+      if (Memory == nullptr) throw bad_alloc();
+
+      Counter* Counters = static_cast<Counter*>(Memory);
+      for (int I = 0; I < 2 * Stripes; I++)
+         new (&Counters[I]) Counter();
+      return Counters;
+   }
+
+   // give back counters from newCounters
+   static void deleteCounters(Counter* Counters) {
+      for (int I = 0; I < 2 * Stripes; I++)
+         Counters[I].~Counter();
+#if defined(_WIN32)
+      _aligned_free(Counters);
+#else
+      free(Counters);
+#endif
+   }
+
+   // stripe of the calling thread; threads are handed stripes in turn
+   static int stripe() {
+      static atomic<int> NextStripe(0);
+      thread_local int Index =
+         NextStripe.fetch_add(1, memory_order_relaxed) % Stripes;
+      return Index;
+   }
+
+   // height of a Node, nullptr is 0
+   static int height(const Node* N) {
+      return (N == nullptr ? 0 : N->Height);
+   }
+
+   // new Node, not yet visible to readers
+   const Node* newNode(const T& Item, const Node* L, const Node* R) {
+      Node* N = Pool.allocate(1);
+      try {
+         new (N) Node(Item, L, R);
+      }
+      catch (...) {
+         Pool.deallocate(N, 1);
+         throw;
+      }
+      return N;
+   }
+
+   // destroy N and give its memory back to the pool
+   void deleteNode(const Node* N) {
+      Node* Mutable = const_cast<Node*>(N);
+      Mutable->~Node();
+      Pool.deallocate(Mutable, 1);
+   }
+
+   // N is being replaced; free it once no reader can see it
+   void retire(const Node* N) {
+      Retired.push_back(N);
+   }
+
+   // make NewRoot the tree readers see, and free retired Nodes if there
+   // are enough of them
+   void publish(const Node* NewRoot) {
+      Root.store(NewRoot);
+      if (static_cast<int>(Retired.size()) >= RetireBatch) reclaim();
+   }
+
+   // wait for a grace period, then free every retired Node
+   void reclaim() {
+      waitForReaders();
+      for (const Node* N : Retired)
+         deleteNode(N);
+      Retired.clear();
+   }
+
+   // wait until every reader that started before this call has finished
+   // flipping Phase sends new readers to the other counters; waiting for
+   // both phases to drain in turn covers a reader that read Phase just
+   // before a flip but counted itself just after it
+   void waitForReaders() {
+      for (int Round = 0; Round < 2; Round++) {
+         int Old = Phase.load();
+         Phase.store(1 - Old);
+         for (int S = 0; S < Stripes; S++) {
+            while (Readers[Old * Stripes + S].Readers.load() != 0)
+               this_thread::yield();
+         }
+      }
+   }
+
+   // retire every Node of the tree at N, then free them all once readers
+   // are done with them
+   void freeTree(const Node* N) {
+      const Node* Stack[MaxHeight];
+      int Top = 0;
+      while (N != nullptr || Top > 0) {
+         if (N == nullptr) N = Stack[--Top];
+         if (N->Right != nullptr) Stack[Top++] = N->Right;
+         retire(N);
+         N = N->Left;
+      }
+      reclaim();
+   }
+
+   // Node holding Data over L and R, rotated so that the heights of its
+   // subtrees differ by at most 1 (L and R are each balanced and differ
+   // in height by at most 2); the Node rotated down is retired
+   const Node* balance(const T& Data, const Node* L, const Node* R) {
+      if (height(L) > height(R) + 1) {
+         if (height(L->Left) >= height(L->Right)) {
+            // L comes up, Data goes down to its right
+            retire(L);
+            return newNode(L->Data, L->Left, newNode(Data, L->Right, R));
+         }
+         // L's right child comes up between L and Data
+         const Node* LR = L->Right;
+         retire(L);
+         retire(LR);
+         return newNode(LR->Data, newNode(L->Data, L->Left, LR->Left),
+            newNode(Data, LR->Right, R));
+      }
+
+      if (height(R) > height(L) + 1) {
+         if (height(R->Right) >= height(R->Left)) {
+            retire(R);
+            return newNode(R->Data, newNode(Data, L, R->Left), R->Right);
+         }
+         const Node* RL = R->Left;
+         retire(R);
+         retire(RL);
+         return newNode(RL->Data, newNode(Data, L, RL->Left),
+            newNode(R->Data, RL->Right, R->Right));
+      }
+
+      return newNode(Data, L, R);
+   }
+
+   // new version of the subtree at N with Item added; returns N itself
+   // and leaves Added false if Item was already there
+   const Node* insert(const Node* N, const T& Item, bool& Added) {
+      if (N == nullptr) {
+         Added = true;
+         return newNode(Item, nullptr, nullptr);
+      }
+
+      if (Item < N->Data) {
+         const Node* L = insert(N->Left, Item, Added);
+         if (!Added) return N;
+         retire(N);
+         return balance(N->Data, L, N->Right);
+      }
+
+      if (N->Data < Item) {
+         const Node* R = insert(N->Right, Item, Added);
+         if (!Added) return N;
+         retire(N);
+         return balance(N->Data, N->Left, R);
+      }
+
+      return N; // duplicate
+   }
+
+   // new version of the subtree at N without Item; returns N itself and
+   // leaves Removed false if Item was not there
+   const Node* erase(const Node* N, const T& Item, bool& Removed) {
+      if (N == nullptr) return nullptr;
+
+      if (Item < N->Data) {
+         const Node* L = erase(N->Left, Item, Removed);
+         if (!Removed) return N;
+         retire(N);
+         return balance(N->Data, L, N->Right);
+      }
+
+      if (N->Data < Item) {
+         const Node* R = erase(N->Right, Item, Removed);
+         if (!Removed) return N;
+         retire(N);
+         return balance(N->Data, N->Left, R);
+      }
+
+      Removed = true;
+      retire(N);
+      if (N->Left == nullptr) return N->Right;
+      if (N->Right == nullptr) return N->Left;
+
+      // 2 children: the smallest Item of the right subtree takes N's place
+      // (Smallest is retired, but not freed before this call ends)
+      const Node* Smallest = nullptr;
+      const Node* R = eraseSmallest(N->Right, Smallest);
+      return balance(Smallest->Data, N->Left, R);
+   }
+
+   // new version of the subtree at N without its smallest Node, which is
+   // returned in Smallest
+   const Node* eraseSmallest(const Node* N, const Node*& Smallest) {
+      retire(N);
+      if (N->Left == nullptr) {
+         Smallest = N;
+         return N->Right;
+      }
+
+      const Node* L = eraseSmallest(N->Left, Smallest);
+      return balance(N->Data, L, N->Right);
+   }
+};
+
+template<class T>
+const int ConcurrentBST<T>::Stripes;
+template<class T>
+const int ConcurrentBST<T>::RetireBatch;
+template<class T>
+const int ConcurrentBST<T>::MaxHeight;
+
+#endif
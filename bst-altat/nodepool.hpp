@@ -0,0 +1,197 @@
+// Tanvir Tatla
+
+// NodePool class
+// Allocator that hands out single objects (tree Nodes) from large blocks
+// Default allocator of BST, usable with any container that allocates one
+// object at a time
+//   -- allocate(1) takes the most recently freed slot, else the next unused
+//      slot of the newest block, else a new block twice the size of the
+//      last one (up to MaxBlockSlots)
+//   -- deallocate(P, 1) puts the slot on a free list for reuse; blocks are
+//      only given back by release() or when the last copy is destroyed
+//   -- release() frees every block at once, in O(blocks), without looking
+//      at the objects in them: the caller must be done with all of them,
+//      including those allocated through copies of the pool
+//   -- allocations of more than one object go to operator new
+//   -- copies share one set of blocks (held by a shared_ptr) and compare
+//      equal, so memory from one can be given back to the other; a pool
+//      rebound to another type starts its own blocks
+//   -- a container copied with select_on_container_copy_construction gets
+//      a new pool, so copying a BST does not share its blocks
+//   -- moving a pool moves its blocks, so containers can steal them; the
+//      moved-from pool starts new blocks if it is used again
+//   -- a pool and its copies must not be used on several threads at once
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+using namespace std;
+
+template<class T>
+class NodePool {
+public:
+   using value_type = T;
+   using propagate_on_container_copy_assignment = false_type;
+   using propagate_on_container_move_assignment = true_type;
+   using propagate_on_container_swap = true_type;
+   using is_always_equal = false_type;
+
+   template<class U>
+   struct rebind {
+      using other = NodePool<U>;
+   };
+
+   // constructor, empty pool
+   NodePool() : Shared(make_shared<State>()) {}
+
+   // copies share Other's blocks
+   NodePool(const NodePool& Other) noexcept : Shared(Other.Shared) {}
+
+   // a pool for another type can not share blocks, so it starts its own
+   template<class U>
+   explicit NodePool(const NodePool<U>& /*Other*/)
+      : Shared(make_shared<State>()) {}
+
+   // takes Other's blocks, Other starts new ones if used again
+   NodePool(NodePool&& Other) noexcept : Shared(move(Other.Shared)) {}
+
+   // shares Other's blocks; its own are freed if no copy holds them
+   NodePool& operator=(const NodePool& Other) noexcept {
+      Shared = Other.Shared;
+      return *this;
+   }
+
+   // takes Other's blocks; its own are freed if no copy holds them
+   NodePool& operator=(NodePool&& Other) noexcept {
+      if (this != &Other) Shared = move(Other.Shared);
+      return *this;
+   }
+
+   // a copied container gets a new pool rather than sharing this one
+   NodePool select_on_container_copy_construction() const {
+      return NodePool();
+   }
+
+   // memory for N objects, uninitialized
+   T* allocate(size_t N) {
+      if (N != 1) return static_cast<T*>(::operator new(N * sizeof(T)));
+      if (Shared == nullptr) Shared = make_shared<State>();
+
+      State& S = *Shared;
+      if (S.FreeList != nullptr) {
+         Slot* Free = S.FreeList;
+         S.FreeList = Free->Next;
+         return reinterpret_cast<T*>(Free);
+      }
+
+      if (S.Unused == S.End) S.addBlock();
+      return reinterpret_cast<T*>(S.Unused++);
+   }
+
+   // give back memory for N objects from allocate(N) of this pool or a
+   // copy of it
+   void deallocate(T* P, size_t N) noexcept {
+      if (N != 1) {
+         ::operator delete(P);
+         return;
+      }
+
+      Slot* Free = reinterpret_cast<Slot*>(P);
+      Free->Next = Shared->FreeList;
+      Shared->FreeList = Free;
+   }
+
+   // free every block; all memory from allocate(1) of this pool and its
+   // copies becomes invalid
+   void release() noexcept {
+      if (Shared != nullptr) Shared->release();
+   }
+
+   // number of blocks held
+   int blocks() const {
+      int Count = 0;
+      if (Shared != nullptr) {
+         for (Slot* B = Shared->Blocks; B != nullptr; B = B->Next)
+            Count++;
+      }
+      return Count;
+   }
+
+   // true if memory from one can be given back to the other
+   bool operator==(const NodePool& Other) const {
+      return Shared == Other.Shared;
+   }
+
+   bool operator!=(const NodePool& Other) const {
+      return !(*this == Other);
+   }
+
+private:
+   // one object, or the link to the next free slot once it is freed
+   // (the first slot of every block links to the block before it)
+   union Slot {
+      Slot* Next;
+      typename aligned_storage<sizeof(T), alignof(T)>::type Storage;
+   };
+
+   // slots in the first block, and the most in any block
+   static const int FirstBlockSlots = 64;
+   static const int MaxBlockSlots = 1 << 16;
+
+   // blocks and free list shared by a pool and its copies
+   struct State {
+      // newest block, linked to older ones through their first slot
+      Slot* Blocks{ nullptr };
+      // freed slots, most recently freed first
+      Slot* FreeList{ nullptr };
+      // next never used slot of the newest block, and the end of that block
+      Slot* Unused{ nullptr };
+      Slot* End{ nullptr };
+      // usable slots in the newest block
+      int BlockSlots{ 0 };
+
+      State() = default;
+      State(const State&) = delete;
+      State& operator=(const State&) = delete;
+
+      // destructor, frees every block once no copy holds them
+      ~State() {
+         release();
+      }
+
+      // allocate a block twice as large as the last one
+      void addBlock() {
+         int Slots = (BlockSlots == 0 ? FirstBlockSlots
+            : (BlockSlots < MaxBlockSlots ? 2 * BlockSlots : MaxBlockSlots));
+         auto Block = static_cast<Slot*>(
+            ::operator new((Slots + 1) * sizeof(Slot)));
+         Block->Next = Blocks;
+         Blocks = Block;
+         Unused = Block + 1;
+         End = Block + 1 + Slots;
+         BlockSlots = Slots;
+      }
+
+      // free every block
+      void release() noexcept {
+         while (Blocks != nullptr) {
+            Slot* Previous = Blocks->Next;
+            ::operator delete(Blocks);
+            Blocks = Previous;
+         }
+         FreeList = nullptr;
+         Unused = nullptr;
+         End = nullptr;
+         BlockSlots = 0;
+      }
+   };
+
+   // this pool's blocks, null once moved from until it allocates again
+   shared_ptr<State> Shared;
+};
+
+#endif
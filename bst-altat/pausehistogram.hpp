@@ -0,0 +1,120 @@
+// Tanvir Tatla
+
+// PauseHistogram class
+// Counts pauses (e.g. a BST rebuilding a subtree) by how long they took,
+// so that the tail latency they add to operations can be checked
+//   -- bucket B counts pauses from 2^B to 2^(B + 1) - 1 nanoseconds
+//      (bucket 0 also counts pauses under 1 ns); the last bucket counts
+//      every longer pause too
+//   -- record and recordSince are O(1) and never allocate
+//   -- percentile(P) gives the upper end of the bucket holding the pause
+//      P percent of the way up, so it errs on the long side by less than
+//      2x, and never exceeds longest()
+//   -- operator<< prints the buckets that are not empty
+
+#ifndef PAUSEHISTOGRAM_HPP
+#define PAUSEHISTOGRAM_HPP
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+class PauseHistogram {
+   // display the buckets that are not empty, one per line
+   friend ostream& operator<<(ostream& Out, const PauseHistogram& Pauses) {
+      for (int B = 0; B < Buckets; B++) {
+         if (Pauses.Counts[B] == 0) continue;
+         Out << setw(14) << (B == 0 ? 0 : 1LL << B) << " ns "
+            << setw(10) << Pauses.Counts[B] << endl;
+      }
+      return Out;
+   }
+
+public:
+   // number of buckets, the last one starts at about 9 minutes
+   static const int Buckets = 40;
+
+   // constructor, no pauses
+   PauseHistogram() = default;
+
+   // count a pause of Nanoseconds
+   void record(long long Nanoseconds) {
+      Counts[bucket(Nanoseconds)]++;
+      Pauses++;
+      Total += Nanoseconds;
+      if (Nanoseconds > Longest) Longest = Nanoseconds;
+   }
+
+   // count a pause from Start until now
+   void recordSince(chrono::steady_clock::time_point Start) {
+      record(chrono::duration_cast<chrono::nanoseconds>(
+         chrono::steady_clock::now() - Start).count());
+   }
+
+   // number of pauses
+   long long count() const {
+      return Pauses;
+   }
+
+   // number of pauses in bucket B
+   long long count(int B) const {
+      return (B < 0 || B >= Buckets ? 0 : Counts[B]);
+   }
+
+   // nanoseconds of all pauses together
+   long long total() const {
+      return Total;
+   }
+
+   // nanoseconds of the longest pause, 0 if none
+   long long longest() const {
+      return Longest;
+   }
+
+   // nanoseconds that P percent of the pauses do not exceed (to within
+   // the bucket), 0 if none
+   long long percentile(double P) const {
+      long long Wanted = static_cast<long long>(P / 100 * Pauses + 0.5);
+      if (Wanted < 1) Wanted = 1;
+
+      long long Seen = 0;
+      for (int B = 0; B < Buckets; B++) {
+         Seen += Counts[B];
+         if (Seen >= Wanted) {
+            long long Upper = (B == Buckets - 1 ? Longest : (2LL << B) - 1);
+            return (Upper < Longest ? Upper : Longest);
+         }
+      }
+
+      return Longest;
+   }
+
+   // forget all pauses
+   void clear() {
+      for (long long& Count : Counts)
+         Count = 0;
+      Pauses = 0;
+      Total = 0;
+      Longest = 0;
+   }
+
+private:
+   // pauses per bucket
+   long long Counts[Buckets]{};
+   // number of pauses, their sum and the longest, in nanoseconds
+   long long Pauses{ 0 };
+   long long Total{ 0 };
+   long long Longest{ 0 };
+
+   // bucket of a pause: the position of its highest 1 bit
+   static int bucket(long long Nanoseconds) {
+      int B = 0;
+      while (B < Buckets - 1 && (Nanoseconds >> (B + 1)) != 0)
+         B++;
+      return B;
+   }
+};
+
+#endif
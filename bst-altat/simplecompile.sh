@@ -19,7 +19,7 @@ date
 echo
 echo "*** compiling with clang++ to create an executable called myprogram"
 clang++ --version
-clang++ -std=c++14 -Wall -Wextra -Wno-sign-compare *.cpp -g -o myprogram
+clang++ -std=c++14 -Wall -Wextra -Wno-sign-compare main.cpp bsttest.cpp -pthread -g -o myprogram
 
 echo
 echo "*** running clang-tidy using options from .clang-tidy"